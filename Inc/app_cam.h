@@ -20,12 +20,26 @@
 
 #define CAMERA_FPS 30
 
+typedef struct
+{
+  uint32_t frames;   /* frames written by the NN pipe */
+  uint32_t suspends; /* pipe held because the next buffer was still read by the NPU */
+  uint32_t drops;    /* completed frames superseded before being taken */
+} CAM_NNPipeStats_t;
+
 void CAM_Init(void);
 void CAM_DeInit(void);
 void CAM_Start(void);
 void CAM_DisplayPipe_Start(uint8_t *display_pipe_dst, uint32_t cam_mode);
 void CAM_DisplayPipe_Stop(void);
 void CAM_NNPipe_Start(uint8_t *nn_pipe_dst, uint32_t cam_mode);
+void CAM_NNPipe_DoubleBufferStart(uint8_t *nn_pipe_dst1, uint8_t *nn_pipe_dst2, uint32_t cam_mode);
+uint8_t *CAM_NNPipe_GetFrame(void);
+void CAM_NNPipe_ReleaseFrame(void);
+void CAM_NNPipe_GetStats(CAM_NNPipeStats_t *stats);
+void CAM_NNPipe_SetRoi(float x_center, float y_center, float width, float height);
+void CAM_NNPipe_ResetRoi(void);
+void CAM_NNPipe_GetRoi(uint32_t *offset_x, uint32_t *offset_y, uint32_t *width, uint32_t *height);
 void CAM_IspUpdate(void);
 void CAM_Sensor_Start(void);
 void CAM_Sensor_Stop(void);
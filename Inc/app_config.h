@@ -28,6 +28,18 @@
 #define CPU_FRQ_SCALE_DOWN     0  /* Scale down mode: CPU is clocked using HSE before inference */
 #endif
 
+#ifndef CPU_FRQ_SCALE_DOWN_ADAPTIVE
+#define CPU_FRQ_SCALE_DOWN_ADAPTIVE 0 /* 1: CPU clock only lowered during NPU waits expected longer than the break-even */
+#endif
+
+#ifndef CPU_FRQ_SCALE_DOWN_BREAK_EVEN_US
+#define CPU_FRQ_SCALE_DOWN_BREAK_EVEN_US 30 /* shorter NPU waits keep the CPU clock, in us */
+#endif
+
+#if ( CPU_FRQ_SCALE_DOWN_ADAPTIVE == 1 ) && ( CPU_FRQ_SCALE_DOWN == 0 )
+#error "CPU_FRQ_SCALE_DOWN_ADAPTIVE requires CPU_FRQ_SCALE_DOWN"
+#endif
+
 #ifndef NPU_FRQ_SCALING
 #define NPU_FRQ_SCALING        0  /* NPU frequency scaling (100MHz, 200MHz, 400MHz, 600MHz, 800MHz) and 1GHz if overdrive enabled */
 #endif
@@ -37,6 +49,204 @@
 #define POWER_OVERDRIVE 0
 #endif
 
+#ifndef NPU_FRQ_FAST_SWITCH
+#define NPU_FRQ_FAST_SWITCH    0  /* 1: NPU_FRQ_SCALING switches with RCC register values built once per step, 0: HAL_RCC_OscConfig/ClockConfig */
+#endif
+
+#ifndef CLOCK_MANAGER
+#define CLOCK_MANAGER          0  /* 1: overdrive PLL2/PLL3 powered by reference count of the stages requiring the NPU and NPU RAMs clocks */
+#endif
+
+#if ( CLOCK_MANAGER == 1 ) && ( POWER_OVERDRIVE == 0 )
+#error "CLOCK_MANAGER requires POWER_OVERDRIVE without NPU_FRQ_SCALING"
+#endif
+
+#ifndef NN_PERSISTENT_RUNTIME
+#define NN_PERSISTENT_RUNTIME  0  /* 1: NPU runtime and network initialized once then only reset per inference, 0: full init/de-init per inference */
+#endif
+
+#ifndef NN_CACHE_CHECK
+#define NN_CACHE_CHECK         0  /* 1: outputs of each inference compared with a reference run with full D-cache maintenance between epoch blocks */
+#endif
+
+/* NN warm-up (dry run) policy */
+#define NN_WARMUP_NONE         0  /* no dry run, first inference runs with cold caches and cold external flash */
+#define NN_WARMUP_FIRST_BOOT   1  /* dry run only before the first inference after reset */
+#define NN_WARMUP_EVERY_N      2  /* dry run every NN_WARMUP_PERIOD triggers */
+
+#ifndef NN_WARMUP_POLICY
+#define NN_WARMUP_POLICY       NN_WARMUP_EVERY_N
+#endif
+
+#ifndef NN_WARMUP_PERIOD
+#define NN_WARMUP_PERIOD       1  /* NN_WARMUP_EVERY_N period in triggers, 1: dry run at each trigger */
+#endif
+
+#ifndef NN_EPOCH_TRACE
+#define NN_EPOCH_TRACE         0  /* 1: start and end of each NPU epoch block logged in the timestamp log, 0: whole inference only */
+#endif
+
+#ifndef NN_EPOCH_TRACE_MAX_BLOCKS
+#define NN_EPOCH_TRACE_MAX_BLOCKS 64 /* epoch blocks traced per network, next ones are not logged */
+#endif
+
+/* NPU debug and trace unit profiling of the epoch blocks */
+#define NPU_PROFILE_NONE       0  /* no profiling */
+#define NPU_PROFILE_TRANSFERS  1  /* bytes read and written on the NPU bus interfaces */
+#define NPU_PROFILE_STALLS     2  /* NPU cycles and stream engines active cycles, needs LL_ATON_EB_DBG_INFO */
+
+#ifndef NPU_PROFILE
+#define NPU_PROFILE            NPU_PROFILE_NONE
+#endif
+
+#if ( NPU_PROFILE == NPU_PROFILE_STALLS ) && !defined(LL_ATON_EB_DBG_INFO)
+#error "NPU_PROFILE_STALLS needs the stream engine masks of the epoch blocks, build with LL_ATON_EB_DBG_INFO defined"
+#endif
+
+#ifndef NN_EPOCH_FREQ_PLAN
+#define NN_EPOCH_FREQ_PLAN     0  /* 1: NPU and NPU RAMs clocks divided per epoch block as listed in Inc/nn_freq_plan.h */
+#endif
+
+#ifndef STREAMING_MODE
+#define STREAMING_MODE         0  /* Continuous capture: capture, inference and post-processing of consecutive frames overlap */
+#endif
+
+#ifndef STREAMING_NB_FRAMES
+#define STREAMING_NB_FRAMES    10 /* number of frames processed per USER1 trigger in streaming mode */
+#endif
+
+#if ( STREAMING_MODE == 1 ) && ( NPU_FRQ_SCALING == 1 )
+#error "STREAMING_MODE and NPU_FRQ_SCALING can not be enabled together"
+#endif
+
+#if ( NN_CACHE_CHECK == 1 ) && (( STREAMING_MODE == 1 ) || ( NPU_FRQ_SCALING == 1 ))
+#error "NN_CACHE_CHECK can not be enabled with STREAMING_MODE or NPU_FRQ_SCALING"
+#endif
+
+#ifndef CASCADE_MODE
+#define CASCADE_MODE           0  /* 1: second network (classifier) run on the same frame only when the detector fires */
+#endif
+
+#ifndef CASCADE_DETECTOR_FREQ_STEP
+#define CASCADE_DETECTOR_FREQ_STEP   0 /* frequencySteps index of the detector, used when NPU_FRQ_SCALING is enabled */
+#endif
+
+#ifndef CASCADE_CLASSIFIER_FREQ_STEP
+#define CASCADE_CLASSIFIER_FREQ_STEP 0 /* frequencySteps index of the classifier, used when NPU_FRQ_SCALING is enabled */
+#endif
+
+#if ( CASCADE_MODE == 1 ) && ( STREAMING_MODE == 1 )
+#error "CASCADE_MODE and STREAMING_MODE can not be enabled together"
+#endif
+
+#ifndef DVFS_CALIBRATION
+#define DVFS_CALIBRATION       0  /* 1: NPU_FRQ_SCALING sweeps all voltage, NPU, NPU RAMs and CPU clock combinations */
+#endif
+
+#ifndef DVFS_CALIBRATION_RUNS
+#define DVFS_CALIBRATION_RUNS  3  /* inferences per operating point during the calibration sweep */
+#endif
+
+#ifndef DVFS_OPERATING_POINT
+#define DVFS_OPERATING_POINT   -1 /* >= 0: NPU_FRQ_SCALING runs at this operating point of the calibration, see full_sequence_power.py -d */
+#endif
+
+#if (( DVFS_CALIBRATION == 1 ) || ( DVFS_OPERATING_POINT >= 0 )) && (( NPU_FRQ_SCALING == 0 ) || ( CASCADE_MODE == 1 ))
+#error "DVFS_CALIBRATION and DVFS_OPERATING_POINT require NPU_FRQ_SCALING without CASCADE_MODE"
+#endif
+
+#if ( DVFS_CALIBRATION == 1 ) && ( DVFS_OPERATING_POINT >= 0 )
+#error "DVFS_CALIBRATION and DVFS_OPERATING_POINT can not be enabled together"
+#endif
+
+#ifndef SMPS_POWER_GOOD_WAIT
+#define SMPS_POWER_GOOD_WAIT   0  /* 1: SMPS transitions wait for VddCore with the VddCORE monitor instead of a fixed 10 ms delay */
+#endif
+
+#ifndef SMPS_OVERDRIVE_BATCH
+#define SMPS_OVERDRIVE_BATCH   1  /* DVFS_OPERATING_POINT: triggers sharing one overdrive window, 1: back to nominal after each inference */
+#endif
+
+#ifndef SMPS_LATENCY_BUDGET_US
+#define SMPS_LATENCY_BUDGET_US 0  /* DVFS_OPERATING_POINT: > 0, an overdrive point is replaced by the fastest nominal one meeting this latency */
+#endif
+
+#if (( SMPS_OVERDRIVE_BATCH > 1 ) || ( SMPS_LATENCY_BUDGET_US > 0 )) && ( DVFS_OPERATING_POINT < 0 )
+#error "SMPS_OVERDRIVE_BATCH and SMPS_LATENCY_BUDGET_US require DVFS_OPERATING_POINT"
+#endif
+
+#ifndef ROI_SECOND_PASS
+#define ROI_SECOND_PASS        0  /* 1: frame re-captured with a DCMIPP crop around the top detection and inferred again */
+#endif
+
+#ifndef ROI_SECOND_PASS_MARGIN
+#define ROI_SECOND_PASS_MARGIN 150 /* ROI size in percent of the detection box, never smaller than the NN input */
+#endif
+
+#if ( ROI_SECOND_PASS == 1 ) && (( STREAMING_MODE == 1 ) || ( CASCADE_MODE == 1 ))
+#error "ROI_SECOND_PASS can not be enabled with STREAMING_MODE or CASCADE_MODE"
+#endif
+
+#ifndef MOTION_GATE
+#define MOTION_GATE            0  /* 1: inference skipped when the frame did not change since the last inference */
+#endif
+
+#ifndef MOTION_GATE_CELL_DIFF
+#define MOTION_GATE_CELL_DIFF  12 /* luminance difference (0-255) for a thumbnail cell to be considered changed */
+#endif
+
+#ifndef MOTION_GATE_MIN_CELLS
+#define MOTION_GATE_MIN_CELLS  2  /* number of changed cells (out of MOTION_GRID x MOTION_GRID) to run the inference */
+#endif
+
+#ifndef MOTION_GATE_MAX_SKIP
+#define MOTION_GATE_MAX_SKIP   10 /* inference forced after this number of consecutive skipped frames, 0: never */
+#endif
+
+#if ( MOTION_GATE == 1 ) && ( STREAMING_MODE == 1 )
+#error "MOTION_GATE can not be enabled with STREAMING_MODE"
+#endif
+
+#ifndef PWR_TIMESTAMP_BINARY
+#define PWR_TIMESTAMP_BINARY   0  /* 1: timestamps sent as a compact binary frame over UART DMA, 0: ASCII lines */
+#endif
+
+#ifndef PWR_TIMESTAMP_HIGHRES
+#define PWR_TIMESTAMP_HIGHRES  0  /* 1: timestamps in ns from the DWT cycle counter, aligned on TIM2, 0: TIM2 us timestamps */
+#endif
+
+#ifndef PWR_TIMESTAMP_BACKGROUND_DRAIN
+#define PWR_TIMESTAMP_BACKGROUND_DRAIN 0 /* 1: timestamps sent while waiting for a trigger, console kept on during the sequence */
+#endif
+
+#ifndef CONSOLE_BAUDRATE
+#if ( PWR_TIMESTAMP_BINARY == 1 )
+#define CONSOLE_BAUDRATE       921600
+#else
+#define CONSOLE_BAUDRATE       115200
+#endif
+#endif
+
+#ifndef CAMERA_WARM_MODE
+#define CAMERA_WARM_MODE       0  /* 1: camera sensor in standby between triggers, 0: full camera init/de-init per trigger */
+#endif
+
+#ifndef EXTMEM_EARLY_INIT
+#define EXTMEM_EARLY_INIT      0  /* 1: external flash (and PSRAM) initialized during camera capture, 0: after capture */
+#endif
+
+#ifndef PERIODIC_CAPTURE
+#define PERIODIC_CAPTURE       0  /* 1: USER1 starts/stops LPTIM1 periodic triggers, 0: one trigger per USER1 push */
+#endif
+
+#ifndef PERIODIC_CAPTURE_PERIOD_MS
+#define PERIODIC_CAPTURE_PERIOD_MS 1000 /* trigger period in periodic capture mode */
+#endif
+
+#ifndef IDLE_STOP_MODE
+#define IDLE_STOP_MODE         0  /* 1: STOP mode between triggers (RAM retained, clocks restored at wake-up), 0: SLEEP mode */
+#endif
+
 #ifndef USE_PSRAM
 #define USE_PSRAM              0  /* enable/disable using external RAM */
 #endif
@@ -64,7 +274,9 @@
 #define LCD_FG_FRAMEBUFFER_SIZE  (LCD_FG_WIDTH * LCD_FG_HEIGHT * 2)
 
 /* Model Related Info */
-#define POSTPROCESS_TYPE    POSTPROCESS_OD_YOLO_V2_UF
+#ifndef POSTPROCESS_TYPE
+#define POSTPROCESS_TYPE    POSTPROCESS_OD_YOLO_V2_UF /* POSTPROCESS_OD_YOLO_V2_UI for a network generated with an int8 output */
+#endif
 
 #define NN_WIDTH 224
 #define NN_HEIGHT 224
@@ -82,6 +294,10 @@
 #define AI_OD_YOLOV2_PP_GRID_HEIGHT       (7)
 #define AI_OD_YOLOV2_PP_NB_INPUT_BOXES    (AI_OD_YOLOV2_PP_GRID_WIDTH * AI_OD_YOLOV2_PP_GRID_HEIGHT)
 
+/* Quantization of the int8 output (POSTPROCESS_OD_YOLO_V2_UI): input of the Dequantize_54 layer */
+#define AI_OD_YOLOV2_PP_SCALE             (0.146129816770554f)
+#define AI_OD_YOLOV2_PP_ZERO_POINT        (11)
+
 /* Anchor boxes */
 static const float32_t AI_OD_YOLOV2_PP_ANCHORS[2*AI_OD_YOLOV2_PP_NB_ANCHORS] = {
     0.9883000000f,     3.3606000000f,
@@ -0,0 +1,31 @@
+/**
+ ******************************************************************************
+ * @file    app_dvfs.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+#ifndef APP_DVFS_H
+#define APP_DVFS_H
+
+#include <stdint.h>
+#include "system_clock.h"
+
+/* voltage, NPU, NPU RAMs and CPU clock combinations swept by the calibration */
+#define DVFS_MAX_OPERATING_POINTS 32
+
+void DVFS_Init(const FrequencyStep *steps, uint32_t nbSteps);
+uint32_t DVFS_GetNbOperatingPoints(void);
+const FrequencyStep *DVFS_GetOperatingPoint(uint32_t index);
+
+#endif /* APP_DVFS_H */
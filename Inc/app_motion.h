@@ -0,0 +1,29 @@
+ /**
+ ******************************************************************************
+ * @file    app_motion.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+#ifndef APP_MOTION_H
+#define APP_MOTION_H
+
+#include <stdint.h>
+
+/* frame thumbnail used by the motion gate: MOTION_GRID x MOTION_GRID cells */
+#define MOTION_GRID 16
+
+uint32_t MOTION_Score(const uint8_t *frame, uint32_t width, uint32_t height, uint32_t bpp);
+void MOTION_SetReference(void);
+
+#endif /* APP_MOTION_H */
@@ -0,0 +1,41 @@
+ /**
+ ******************************************************************************
+ * @file    app_nn.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2024 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+#ifndef APP_NN_H
+#define APP_NN_H
+
+#include "ll_aton_runtime.h"
+
+typedef enum
+{
+  NN_POLL_BUSY = 0, /* NPU runs a hardware epoch, poll again on the next NPU event */
+  NN_POLL_DONE,     /* inference completed, completion callback called */
+} NN_PollStatus_t;
+
+/* completion callback of an asynchronous inference, called from NN_Poll */
+typedef void (*NN_DoneCallback_t)(NN_Instance_TypeDef *nn_instance, void *arg);
+
+void NN_Prepare(NN_Instance_TypeDef *nn_instance);
+void NN_Release(NN_Instance_TypeDef *nn_instance);
+void NN_Run(NN_Instance_TypeDef *nn_instance);
+void NN_Start(NN_Instance_TypeDef *nn_instance, NN_DoneCallback_t done, void *arg);
+NN_PollStatus_t NN_Poll(NN_Instance_TypeDef *nn_instance);
+int NN_CacheCheck(NN_Instance_TypeDef *nn_instance);
+void NN_CacheCheckReport(void);
+void NN_DeInit(NN_Instance_TypeDef *nn_instance);
+
+#endif /* APP_NN_H */
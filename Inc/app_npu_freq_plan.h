@@ -0,0 +1,31 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_freq_plan.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+#ifndef APP_NPU_FREQ_PLAN_H
+#define APP_NPU_FREQ_PLAN_H
+
+#include <stdint.h>
+
+/* networks with a frequency plan, each one identified by a slot given by the caller */
+#define NPU_FREQ_PLAN_NETWORKS 2
+
+void NPU_FREQ_PLAN_SetNetwork(uint32_t network, const char *name);
+void NPU_FREQ_PLAN_EpochStart(uint32_t network, uint32_t block);
+void NPU_FREQ_PLAN_End(uint32_t network, uint32_t nbBlocks);
+void NPU_FREQ_PLAN_Report(void);
+
+#endif /* APP_NPU_FREQ_PLAN_H */
@@ -0,0 +1,32 @@
+ /**
+ ******************************************************************************
+ * @file    app_npu_profile.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+#ifndef APP_NPU_PROFILE_H
+#define APP_NPU_PROFILE_H
+
+#include <stdint.h>
+#include "ll_aton_runtime.h"
+
+/* networks profiled, each one identified by a slot given by the caller */
+#define NPU_PROFILE_NETWORKS 2
+
+void NPU_PROFILE_EpochStart(uint32_t network, uint32_t block, const EpochBlock_ItemTypeDef *epoch_block);
+void NPU_PROFILE_EpochEnd(uint32_t network, uint32_t block, const EpochBlock_ItemTypeDef *epoch_block);
+void NPU_PROFILE_SetNetworkName(uint32_t network, const char *name);
+void NPU_PROFILE_Report(void);
+
+#endif /* APP_NPU_PROFILE_H */
@@ -0,0 +1,34 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_wfe.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+#ifndef APP_NPU_WFE_H
+#define APP_NPU_WFE_H
+
+#include <stdint.h>
+#include "ll_aton_runtime.h"
+
+/* networks followed, each one identified by a slot given by the caller */
+#define NPU_WFE_NETWORKS 2
+
+void NPU_WFE_SetNetworkName(uint32_t network, const char *name);
+void NPU_WFE_EpochStart(uint32_t network, uint32_t block, const EpochBlock_ItemTypeDef *epoch_block);
+void NPU_WFE_EpochEnd(uint32_t network, uint32_t block);
+uint32_t NPU_WFE_Enter(void);
+void NPU_WFE_Exit(uint32_t down);
+void NPU_WFE_Report(void);
+
+#endif /* APP_NPU_WFE_H */
@@ -0,0 +1,51 @@
+ /**
+ ******************************************************************************
+ * @file    app_sched.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2024 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+#ifndef APP_SCHED_H
+#define APP_SCHED_H
+
+#include <stdint.h>
+
+#define SCHED_MAX_STAGES 8
+
+/* hardware events, posted from interrupt handlers */
+#define SCHED_EVT_TRIGGER     (1U << 0) /* USER1 push button */
+#define SCHED_EVT_TIMER       (1U << 1) /* periodic trigger timer */
+#define SCHED_EVT_FRAME       (1U << 2) /* DCMIPP NN pipe frame received */
+#define SCHED_EVT_NPU         (1U << 3) /* NPU end of epoch interrupt */
+/* software events, posted by stages on completion */
+#define SCHED_EVT_FRAME_READY (1U << 8) /* frame ready for inference */
+#define SCHED_EVT_NN_DONE     (1U << 9) /* inference done, outputs available */
+#define SCHED_EVT_PP_DONE     (1U << 10) /* post-processing done */
+#define SCHED_EVT_CASCADE     (1U << 11) /* cascade mode: detector fired, classifier to run */
+#define SCHED_EVT_ROI         (1U << 12) /* ROI second pass: first pass detected an object */
+
+typedef struct
+{
+  const char *name;              /* stage name */
+  uint32_t trigger;              /* events activating the stage */
+  void (*run)(uint32_t events);  /* stage handler, runs to completion with the events that activated it */
+} SCHED_Stage_t;
+
+void SCHED_Register(const SCHED_Stage_t *stage);
+void SCHED_Post(uint32_t events);
+void SCHED_Clear(uint32_t events);
+void SCHED_Expect(uint32_t events);
+void SCHED_Run(void);
+void SCHED_IdleHook(uint32_t expected);
+
+#endif /* APP_SCHED_H */
@@ -0,0 +1,29 @@
+ /**
+ ******************************************************************************
+ * @file    app_timer.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2024 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+#ifndef APP_TIMER_H
+#define APP_TIMER_H
+
+#include <stdint.h>
+
+void TIMER_Periodic_Start(uint32_t period_ms);
+void TIMER_Periodic_Stop(void);
+int TIMER_Periodic_IsRunning(void);
+uint32_t TIMER_Periodic_GetTime(uint32_t *period_idx);
+void TIMER_Periodic_IRQHandler(void);
+
+#endif /* APP_TIMER_H */
@@ -21,6 +21,11 @@
 
 
 #include "ll_aton_platform.h"
+#include "app_sched.h"
+#include "app_config.h"
+#if (CPU_FRQ_SCALE_DOWN_ADAPTIVE == 1)
+#include "app_npu_wfe.h"
+#endif
 
 extern void sysclk_SetCpuMaxFreq(void);
 extern void sysclk_SetCpuMinFreq(void);
@@ -31,11 +36,19 @@ extern void HAL_PWR_EnterSLEEPMode(uint32_t Regulator, uint8_t SLEEPEntry);
 #define LL_ATON_OSAL_DEINIT()
 
 /* Wait for / signal event from ATON runtime HAL_PWR_EnterSLEEPMode(0, PWR_SLEEPENTRY_WFE);  */
+#if (CPU_FRQ_SCALE_DOWN_ADAPTIVE == 1)
+/* CPU clock only lowered when the expected wait of the epoch block is worth it */
+#define LL_ATON_OSAL_WFE()  do { uint32_t down = NPU_WFE_Enter();\
+	                             __WFE();\
+	                             NPU_WFE_Exit(down);\
+	                           } while(0)
+#else
 #define LL_ATON_OSAL_WFE()  do { sysclk_SetCpuMinFreq();\
 	                             __WFE();\
 	                             sysclk_SetCpuMaxFreq();\
 	                           } while(0)
+#endif
 
-#define LL_ATON_OSAL_SIGNAL_EVENT()
+#define LL_ATON_OSAL_SIGNAL_EVENT() SCHED_Post(SCHED_EVT_NPU)
 
 #endif // __LL_ATON_OSAL_USER_H
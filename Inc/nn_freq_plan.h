@@ -0,0 +1,30 @@
+/**
+ ******************************************************************************
+ * @file    nn_freq_plan.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+#ifndef NN_FREQ_PLAN_H
+#define NN_FREQ_PLAN_H
+
+/* Per epoch block NPU clock plan, used when NN_EPOCH_FREQ_PLAN is enabled.
+ * One entry per epoch block changing the clocks:
+ *   { "<network name>", <epoch block>, <NPU clock divider>, <NPU RAMs clock divider> },
+ * dividers are relative to the clocks of the inference and apply until the next entry
+ * of the network. Clocks of the inference are restored at the end of the network.
+ * Can be generated with: full_sequence_power.py <capture> -e --plan ../../Inc/nn_freq_plan.h
+ */
+#define NN_FREQ_PLAN
+
+#endif /* NN_FREQ_PLAN_H */
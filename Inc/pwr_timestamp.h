@@ -18,9 +18,19 @@
 #ifndef PWR_TIMESTAMP_H
 #define PWR_TIMESTAMP_H
 
+#include <stdint.h>
+
 void pwr_timestamp_init(void);
 void pwr_timestamp_log(const char *stepName);
+uint32_t pwr_timestamp_get(void);
+uint32_t pwr_timestamp_get_ns(void);
 void pwr_timestamp_sendOverUart(void);
+uint32_t pwr_timestamp_pending(void);
+void pwr_timestamp_drain(uint32_t max_entries);
+void pwr_timestamp_drain_async(uint32_t max_entries);
+uint32_t pwr_timestamp_drain_busy(void);
+void pwr_timestamp_drain_wait(void);
+void pwr_timestamp_cpu_clock_changed(void);
 
 void pwr_timestamp_stop(void);
 void pwr_timestamp_start(void);
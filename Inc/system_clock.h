@@ -26,6 +26,7 @@ typedef struct
 	RCC_PLLInitTypeDef pll2Cfg;
 	RCC_PLLInitTypeDef pll3Cfg;
 	uint32_t npufreq;
+	uint32_t overdrive;  /* 1: VddCore raised to overdrive for this step */
 	uint32_t cpuClkSrc;
 	uint32_t npuClkSrc;
 	uint32_t npuRamsClkSrc;
@@ -34,8 +35,16 @@ typedef struct
 
 
 
-void sysclk_NpuFreqScaling(FrequencyStep *frequencySteps);
+void sysclk_NpuFreqScaling(const FrequencyStep *frequencySteps);
+void sysclk_NpuFreqScalingPrepare(const FrequencyStep *frequencySteps);
+void sysclk_NpuFreqScalingReport(void);
+void sysclk_NpuSetClockDividers(uint32_t npuDiv, uint32_t ramsDiv);
+void sysclk_NpuGetClockDividers(uint32_t *npuDiv, uint32_t *ramsDiv);
+uint32_t sysclk_GetNpuClockFreq(void);
+void sysclk_SmpsHoldOverdrive(uint32_t hold);
+void sysclk_SmpsReport(void);
 void sysclk_SystemClockConfig(void);
+void sysclk_SystemClockRestore(void);
 void sysclk_NpuOverDriveClockConfig(RCC_ClkInitTypeDef *pRCC_ClkInitStruct);
 void sysclk_NpuRamsOverDriveClockConfig(RCC_ClkInitTypeDef *pRCC_ClkInitStruct);
 void sysclk_NpuOverDrivePllDeinit(RCC_ClkInitTypeDef *pRCC_ClkInitStruct);
@@ -47,4 +56,14 @@ void sysclk_NpuClockDisable(void);
 void sysclk_NpuClockConfig(void);
 void sysclk_CpuClockConfig(void);
 
+/* clocks of sysclk_ClockPreLock, sysclk_ClockRequire and sysclk_ClockRelease (CLOCK_MANAGER) */
+#define SYSCLK_CLOCK_NPU       (1U << 0)  /* IC6 on PLL2 */
+#define SYSCLK_CLOCK_NPU_RAMS  (1U << 1)  /* IC11 on PLL3 */
+
+void sysclk_ClockPreLock(uint32_t clocks);
+void sysclk_ClockRequire(uint32_t clocks);
+void sysclk_ClockRelease(uint32_t clocks);
+void sysclk_ClockStart(void);
+void sysclk_ClockReport(void);
+
 #endif /* SYSTEM_CLOCK_H */
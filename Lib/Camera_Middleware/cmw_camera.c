@@ -485,7 +485,10 @@ int32_t CMW_CAMERA_DeInit(void)
 
   /* Update DCMIPPInit counter */
   is_camera_init--;
-  is_camera_started--;
+  if (is_camera_started > 0)
+  {
+    is_camera_started--;
+  }
   is_pipe1_2_shared--;
 
   /* Return CMW status */
@@ -531,6 +534,63 @@ int32_t CMW_CAMERA_Resume(uint32_t pipe)
   return CMW_ERROR_NONE;
 }
 
+/**
+  * @brief  Put the camera sensor in standby. Sensor, CSI and DCMIPP configurations are kept
+  *         so that the capture can restart with CMW_CAMERA_SensorStart instead of a full init.
+  * @retval CMW status
+  */
+int32_t CMW_CAMERA_SensorStop(void)
+{
+  int32_t ret;
+
+  if (!is_camera_started)
+  {
+    return CMW_ERROR_NONE;
+  }
+
+  if (Camera_Drv.Stop == NULL)
+  {
+    return CMW_ERROR_FEATURE_NOT_SUPPORTED;
+  }
+
+  ret = Camera_Drv.Stop(&camera_bsp);
+  if (ret != CMW_ERROR_NONE)
+  {
+    return CMW_ERROR_COMPONENT_FAILURE;
+  }
+  is_camera_started--;
+
+  /* Return CMW status */
+  return ret;
+}
+
+/**
+  * @brief  Restart the camera sensor streaming after CMW_CAMERA_SensorStop.
+  * @retval CMW status
+  */
+int32_t CMW_CAMERA_SensorStart(void)
+{
+  int32_t ret = CMW_ERROR_NONE;
+
+  if (is_camera_init <= 0)
+  {
+    return CMW_ERROR_NO_INIT;
+  }
+
+  if (!is_camera_started)
+  {
+    ret = Camera_Drv.Start(&camera_bsp);
+    if (ret != CMW_ERROR_NONE)
+    {
+      return CMW_ERROR_COMPONENT_FAILURE;
+    }
+    is_camera_started++;
+  }
+
+  /* Return CMW status */
+  return ret;
+}
+
 /**
   * @brief  Set the camera gain.
   * @param  Gain     Gain in mdB
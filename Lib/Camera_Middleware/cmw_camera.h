@@ -108,6 +108,8 @@ int32_t CMW_CAMERA_Start(uint32_t pipe, uint8_t *pbuff, uint32_t Mode);
 int32_t CMW_CAMERA_DoubleBufferStart(uint32_t pipe, uint8_t *pbuff1, uint8_t *pbuff2, uint32_t Mode);
 int32_t CMW_CAMERA_Suspend(uint32_t pipe);
 int32_t CMW_CAMERA_Resume(uint32_t pipe);
+int32_t CMW_CAMERA_SensorStop(void);
+int32_t CMW_CAMERA_SensorStart(void);
 
 int CMW_CAMERA_SetAntiFlickerMode(int flicker_mode);
 int CMW_CAMERA_GetAntiFlickerMode(int *flicker_mode);
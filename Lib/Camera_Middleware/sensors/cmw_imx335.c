@@ -76,6 +76,7 @@ static int32_t CMW_IMX335_DeInit(void *io_ctx)
   {
     return CMW_ERROR_COMPONENT_FAILURE;
   }
+  ((CMW_IMX335_t *)io_ctx)->IsIspStarted = 0;
 
   ret = IMX335_DeInit(&((CMW_IMX335_t *)io_ctx)->ctx_driver);
   if (ret)
@@ -224,6 +225,12 @@ static int32_t CMW_IMX335_Start(void *io_ctx)
 {
 #ifndef ISP_MW_TUNING_TOOL_SUPPORT
   int ret;
+  /* Restart from standby: ISP is still running, only resume sensor streaming */
+  if (((CMW_IMX335_t *)io_ctx)->IsIspStarted)
+  {
+    return IMX335_Start(&((CMW_IMX335_t *)io_ctx)->ctx_driver);
+  }
+
   /* Statistic area is provided with null value so that it force the ISP Library to get the statistic
    * area information from the tuning file.
    */
@@ -239,10 +246,23 @@ static int32_t CMW_IMX335_Start(void *io_ctx)
   {
       return CMW_ERROR_PERIPH_FAILURE;
   }
+  ((CMW_IMX335_t *)io_ctx)->IsIspStarted = 1;
 #endif
   return IMX335_Start(&((CMW_IMX335_t *)io_ctx)->ctx_driver);
 }
 
+static int32_t CMW_IMX335_Stop(void *io_ctx)
+{
+  int ret;
+
+  ret = IMX335_Stop(&((CMW_IMX335_t *)io_ctx)->ctx_driver);
+  if (ret != IMX335_OK)
+  {
+    return CMW_ERROR_PERIPH_FAILURE;
+  }
+  return CMW_ERROR_NONE;
+}
+
 static int32_t CMW_IMX335_Run(void *io_ctx)
 {
 #ifndef ISP_MW_TUNING_TOOL_SUPPORT
@@ -324,6 +344,7 @@ int CMW_IMX335_Probe(CMW_IMX335_t *io_ctx, CMW_Sensor_if_t *imx335_if)
   memset(imx335_if, 0, sizeof(*imx335_if));
   imx335_if->Init = CMW_IMX335_Init;
   imx335_if->Start = CMW_IMX335_Start;
+  imx335_if->Stop = CMW_IMX335_Stop;
   imx335_if->DeInit = CMW_IMX335_DeInit;
   imx335_if->Run = CMW_IMX335_Run;
   imx335_if->VsyncEventCallback = CMW_IMX335_VsyncEventCallback;
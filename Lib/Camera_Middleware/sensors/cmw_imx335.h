@@ -37,6 +37,7 @@ typedef struct
   ISP_AppliHelpersTypeDef appliHelpers;
   DCMIPP_HandleTypeDef *hdcmipp;
   uint8_t IsInitialized;
+  uint8_t IsIspStarted;
   int32_t (*Init)(void);
   int32_t (*DeInit)(void);
   int32_t (*WriteReg)(uint16_t, uint16_t, uint8_t*, uint16_t);
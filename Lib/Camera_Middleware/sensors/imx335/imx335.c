@@ -485,6 +485,25 @@ int32_t IMX335_Start(IMX335_Object_t *pObj)
   return ret;
 }
 
+/**
+  * @brief  Stop streaming, the sensor goes to standby and keeps its configuration.
+  * @param  pObj  pointer to component object
+  * @retval Component status
+  */
+int32_t IMX335_Stop(IMX335_Object_t *pObj)
+{
+  uint8_t tmp;
+  int32_t ret = IMX335_OK;
+  /* Stop streaming */
+  tmp = IMX335_MODE_STANDBY;
+  ret = imx335_write_reg(&pObj->Ctx, IMX335_REG_MODE_SELECT, &tmp, 1);
+  if (ret != IMX335_OK)
+  {
+    return IMX335_ERROR;
+  }
+  return ret;
+}
+
 /**
   * @brief  De-initializes the camera sensor.
   * @param  pObj  pointer to component object
@@ -49,6 +49,7 @@ extern "C"
 #define POSTPROCESS_OD_YOLO_V8_UI       (13)  /* Yolov8 postprocessing; Input model: uint8; output: int8            */
 #define POSTPROCESS_OD_ST_YOLOX_UF      (14)  /* ST YoloX postprocessing; Input model: uint8; output: float32       */
 #define POSTPROCESS_OD_ST_SSD_UF        (15)  /* ST SSD postprocessing; Input model: uint8; output: float32         */
+#define POSTPROCESS_OD_YOLO_V2_UI       (16)  /* Yolov2 postprocessing; Input model: uint8; output: int8            */
 #define POSTPROCESS_MPE_YOLO_V8_UF      (20)  /* Yolov8 postprocessing; Input model: uint8; output: float32         */
 #define POSTPROCESS_MPE_PD_UF           (21)  /* Palm detector postprocessing; Input model: uint8; output: float32  */
 #define POSTPROCESS_SPE_MOVENET_UF      (22)  /* Movenet postprocessing; Input model: uint8; output: float32        */
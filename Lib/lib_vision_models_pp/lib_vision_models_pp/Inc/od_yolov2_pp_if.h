@@ -25,6 +25,11 @@ typedef struct yolov2_pp_in
 	float32_t* pRaw_detections;
 } yolov2_pp_in_t;
 
+typedef struct yolov2_pp_in_int8
+{
+	int8_t* pRaw_detections;
+} yolov2_pp_in_int8_t;
+
 
 
 /* Generic Static parameters */
@@ -40,6 +45,8 @@ typedef struct yolov2_pp_static_param {
   float32_t	conf_threshold;
   float32_t	iou_threshold;
   const float32_t	*pAnchors;
+  float32_t raw_output_scale;
+  int8_t raw_output_zero_point;
   int32_t nb_detect;
 } yolov2_pp_static_param_t;
 
@@ -70,6 +77,22 @@ int32_t od_yolov2_pp_process(yolov2_pp_in_t *pInput,
                                     yolov2_pp_static_param_t *pInput_static_param);
 
 
+/*!
+ * @brief Object detector post processing : includes output detector remapping,
+ *        nms and score filtering for YoloV2 with 8-bits quantized inputs.
+ *        Output buffer must be provided by the caller, with room for
+ *        nb_input_boxes * nb_anchors detections.
+ *
+ * @param [IN] Pointer on input data
+ *             Pointer on output data
+ *             pointer on static parameters
+ * @retval Error code
+ */
+int32_t od_yolov2_pp_process_int8(yolov2_pp_in_int8_t *pInput,
+                                         od_pp_out_t *pOutput,
+                                         yolov2_pp_static_param_t *pInput_static_param);
+
+
 
 #ifdef __cplusplus
  }
@@ -30,6 +30,20 @@ int32_t yolov2_nms_comparator(const void *pa, const void *pb)
 }
 
 
+int32_t yolov2_nms_comparator_int8(const void *pa, const void *pb)
+{
+    od_pp_outBuffer_t *a = (od_pp_outBuffer_t *)pa;
+    od_pp_outBuffer_t *b = (od_pp_outBuffer_t *)pb;
+    float32_t a_weighted_conf = (a->class_index == AI_YOLOV2_PP_SORT_CLASS) ? a->conf : 0.0f;
+    float32_t b_weighted_conf = (b->class_index == AI_YOLOV2_PP_SORT_CLASS) ? b->conf : 0.0f;
+    float32_t diff = a_weighted_conf - b_weighted_conf;
+
+    if (diff < 0) return 1;
+    else if (diff > 0) return -1;
+    return 0;
+}
+
+
 int32_t yolov2_pp_nmsFiltering_centroid(yolov2_pp_in_t  *pInput,
                                         yolov2_pp_static_param_t *pInput_static_param)
 {
@@ -186,6 +200,169 @@ int32_t yolov2_pp_getNNBoxes_centroid(yolov2_pp_in_t *pInput,
 
 
 
+int32_t yolov2_pp_nmsFiltering_centroid_int8(od_pp_out_t *pOutput,
+                                             yolov2_pp_static_param_t *pInput_static_param)
+{
+    int32_t i, j, k, limit_counter, detections_per_class;
+
+    for (k = 0; k < pInput_static_param->nb_classes; ++k)
+    {
+        limit_counter = 0;
+        detections_per_class = 0;
+        AI_YOLOV2_PP_SORT_CLASS = k;
+
+        /* Counts the number of detections with class k */
+        for (i = 0; i < pInput_static_param->nb_detect; i++)
+        {
+            if (pOutput->pOutBuff[i].class_index == k)
+            {
+                detections_per_class++;
+            }
+        }
+        if (detections_per_class == 0) continue;
+
+        /* Sorts detections based on class k */
+        qsort(pOutput->pOutBuff,
+              pInput_static_param->nb_detect,
+              sizeof(od_pp_outBuffer_t),
+              (_Cmpfun *)yolov2_nms_comparator_int8);
+
+        for (i = 0; i < detections_per_class; i++)
+        {
+            if (pOutput->pOutBuff[i].conf == 0) continue;
+            float32_t *a = &(pOutput->pOutBuff[i].x_center);
+            for (j = i + 1; j < detections_per_class; j++)
+            {
+                float32_t *b = &(pOutput->pOutBuff[j].x_center);
+                if (vision_models_box_iou(a, b) > pInput_static_param->iou_threshold)
+                {
+                    pOutput->pOutBuff[j].conf = 0;
+                }
+            }
+        }
+
+        /* Limits detections count */
+        for (i = 0; i < detections_per_class; i++)
+        {
+            if ((limit_counter < pInput_static_param->max_boxes_limit) &&
+                (pOutput->pOutBuff[i].conf != 0))
+            {
+                limit_counter++;
+            }
+            else
+            {
+                pOutput->pOutBuff[i].conf = 0;
+            }
+        }
+    }
+
+    return (AI_OD_POSTPROCESS_ERROR_NO);
+}
+
+
+int32_t yolov2_pp_scoreFiltering_centroid_int8(od_pp_out_t *pOutput,
+                                               yolov2_pp_static_param_t *pInput_static_param)
+{
+    int32_t det_count = 0;
+
+    for (int32_t i = 0; i < pInput_static_param->nb_detect; i++)
+    {
+        if (pOutput->pOutBuff[i].conf >= pInput_static_param->conf_threshold)
+        {
+            pOutput->pOutBuff[det_count] = pOutput->pOutBuff[i];
+            det_count++;
+        }
+    }
+    pOutput->nb_detect = det_count;
+
+    return (AI_OD_POSTPROCESS_ERROR_NO);
+}
+
+
+/* Boxes are dequantized only when their objectness can reach the confidence threshold:
+ * score = sigmoid(objectness) * softmax(classes) <= sigmoid(objectness), so the other ones are
+ * rejected with a comparison of the quantized objectness. Only the best class of a box is kept,
+ * NMS is done per best class as for YoloV8. */
+int32_t yolov2_pp_getNNBoxes_centroid_int8(yolov2_pp_in_int8_t *pInput,
+                                           od_pp_out_t *pOutput,
+                                           yolov2_pp_static_param_t *pInput_static_param)
+{
+    int32_t error   = AI_OD_POSTPROCESS_ERROR_NO;
+    int32_t nb_classes = pInput_static_param->nb_classes;
+    int32_t anch_stride = (nb_classes + AI_YOLOV2_PP_CLASSPROB);
+    int8_t *pInbuff = (int8_t *)pInput->pRaw_detections;
+    int32_t zero_point = pInput_static_param->raw_output_zero_point;
+    float32_t scale = pInput_static_param->raw_output_scale;
+    float32_t conf_threshold = pInput_static_param->conf_threshold;
+    float32_t grid_width_inv = 1.0f / pInput_static_param->grid_width;
+    float32_t grid_height_inv = 1.0f / pInput_static_param->grid_height;
+    float32_t tmp_in[nb_classes];
+    float32_t tmp_out[nb_classes];
+    float32_t tmp_a[nb_classes];
+    float32_t objectness, best_score;
+    uint32_t class_index;
+    int32_t objectness_min_s8 = -128;
+    int32_t el_offset = 0;
+
+    /* sigmoid(scale * (q - zero_point)) >= conf_threshold <=> q >= logit(conf_threshold) / scale + zero_point,
+     * rounded down: boxes on the boundary are checked on their float score */
+    if (conf_threshold >= 1.0f)
+    {
+        objectness_min_s8 = 128;
+    }
+    else if (conf_threshold > 0.0f)
+    {
+        float32_t q = logf(conf_threshold / (1.0f - conf_threshold)) / scale + zero_point;
+        objectness_min_s8 = (q < -128.0f) ? -128 : (q > 128.0f) ? 128 : (int32_t)floorf(q);
+    }
+
+    pInput_static_param->nb_detect = 0;
+    for (int32_t row = 0; row < pInput_static_param->grid_width; ++row)
+    {
+        for (int32_t col = 0; col < pInput_static_param->grid_height; ++col)
+        {
+            for (int32_t anch = 0; anch < pInput_static_param->nb_anchors; ++anch)
+            {
+                int8_t *pAnchor = &pInbuff[el_offset];
+                el_offset += anch_stride;
+
+                if (pAnchor[AI_YOLOV2_PP_OBJECTNESS] < objectness_min_s8) continue;
+
+                /* dequantize, activate objectness and array of classes pred */
+                objectness = vision_models_sigmoid_f(scale * (float32_t)(pAnchor[AI_YOLOV2_PP_OBJECTNESS] - zero_point));
+                for (int32_t k = 0; k < nb_classes; k++)
+                {
+                    tmp_in[k] = scale * (float32_t)(pAnchor[AI_YOLOV2_PP_CLASSPROB + k] - zero_point);
+                }
+                vision_models_softmax_f(tmp_in, tmp_out, nb_classes, tmp_a);
+                for (int32_t k = 0; k < nb_classes; k++)
+                {
+                    tmp_out[k] *= objectness;
+                }
+
+                vision_models_maxi_if32ou32(tmp_out, nb_classes, &best_score, &class_index);
+
+                if (best_score >= conf_threshold)
+                {
+                    od_pp_outBuffer_t *pBox = &pOutput->pOutBuff[pInput_static_param->nb_detect];
+
+                    pBox->x_center = (col + vision_models_sigmoid_f(scale * (float32_t)(pAnchor[AI_YOLOV2_PP_XCENTER] - zero_point))) * grid_width_inv;
+                    pBox->y_center = (row + vision_models_sigmoid_f(scale * (float32_t)(pAnchor[AI_YOLOV2_PP_YCENTER] - zero_point))) * grid_height_inv;
+                    pBox->width = (pInput_static_param->pAnchors[2 * anch] * expf(scale * (float32_t)(pAnchor[AI_YOLOV2_PP_WIDTHREL] - zero_point))) * grid_width_inv;
+                    pBox->height = (pInput_static_param->pAnchors[2 * anch + 1] * expf(scale * (float32_t)(pAnchor[AI_YOLOV2_PP_HEIGHTREL] - zero_point))) * grid_height_inv;
+                    pBox->conf = best_score;
+                    pBox->class_index = class_index;
+                    pInput_static_param->nb_detect++;
+                }
+            }
+        }
+    }
+
+    return (error);
+}
+
+
+
 /* ----------------------       Exported routines      ---------------------- */
 
 int32_t od_yolov2_pp_reset(yolov2_pp_static_param_t *pInput_static_param)
@@ -221,3 +398,28 @@ int32_t od_yolov2_pp_process(yolov2_pp_in_t *pInput,
     return (error);
 }
 
+
+int32_t od_yolov2_pp_process_int8(yolov2_pp_in_int8_t *pInput,
+                                         od_pp_out_t *pOutput,
+                                         yolov2_pp_static_param_t *pInput_static_param)
+{
+    int32_t error   = AI_OD_POSTPROCESS_ERROR_NO;
+
+    /* Call Get NN boxes first */
+    error = yolov2_pp_getNNBoxes_centroid_int8(pInput,
+                                               pOutput,
+                                               pInput_static_param);
+    if (error != AI_OD_POSTPROCESS_ERROR_NO) return (error);
+
+    /* Then NMS */
+    error = yolov2_pp_nmsFiltering_centroid_int8(pOutput,
+                                                 pInput_static_param);
+    if (error != AI_OD_POSTPROCESS_ERROR_NO) return (error);
+
+    /* And score re-filtering */
+    error = yolov2_pp_scoreFiltering_centroid_int8(pOutput,
+                                                   pInput_static_param);
+
+    return (error);
+}
+
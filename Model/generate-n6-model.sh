@@ -1,6 +1,11 @@
 #!/bin/bash
 
-stedgeai generate --no-inputs-allocation --model quantized_tiny_yolo_v2_224_.tflite --target stm32n6 --st-neural-art default@user_neuralart.json
+# profile of user_neuralart.json: default (serialised schedule) or hw-sw-parallel
+PROFILE=${1:-default}
+# output data type: float32 (default) or int8 (POSTPROCESS_OD_YOLO_V2_UI, no final Dequantize layer)
+OUTPUT_TYPE=${2:-float32}
+
+stedgeai generate --no-inputs-allocation --output-data-type $OUTPUT_TYPE --model quantized_tiny_yolo_v2_224_.tflite --target stm32n6 --st-neural-art $PROFILE@user_neuralart.json
 cp st_ai_output/network.c .
 cp st_ai_output/network_ecblobs.h .
 cp st_ai_output/network_atonbuf.xSPI2.raw network_data.xSPI2.bin
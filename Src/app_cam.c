@@ -18,8 +18,11 @@
 
 #include <assert.h>
 #include "cmw_camera.h"
+#include "cmw_utils.h"
 #include "app_cam.h"
 #include "app_config.h"
+#include "pwr_timestamp.h"
+#include "app_sched.h"
 
 #if defined(USE_IMX335_SENSOR)
   #define GAMMA_CONVERSION 0
@@ -30,6 +33,29 @@
 #endif
 
 extern int32_t cameraFrameReceived;
+extern volatile uint32_t cameraFrameTimestamp;
+
+#if (STREAMING_MODE == 1)
+/* NN pipe double buffer book-keeping, shared between the DCMIPP frame IRQ and the main loop */
+static uint8_t *nnPipeBuffers[2];
+static volatile int32_t nnPipeReadyIdx = -1;  /* last completed buffer not yet taken, -1 if none */
+static volatile int32_t nnPipeLockedIdx = -1; /* buffer currently read by the NPU, -1 if none */
+static volatile int32_t nnPipeSuspended;     /* capture request cleared by the IRQ, HAL suspend left to the thread */
+static volatile uint32_t nnPipeFrames;
+static uint32_t nnPipeFramesBase;
+static volatile uint32_t nnPipeSuspends;
+static volatile uint32_t nnPipeDrops;
+#endif /* STREAMING_MODE */
+
+#if (ROI_SECOND_PASS == 1)
+/* sensor resolution reported by the camera driver */
+static uint32_t camWidth;
+static uint32_t camHeight;
+/* NN pipe areas in sensor coordinates, the ROI is the last one applied and is kept
+ * after the pipe goes back to full frame so it can be reported at the end of the trigger */
+static CMW_Manual_roi_area_t nnPipeFull;
+static CMW_Manual_roi_area_t nnPipeRoi;
+#endif /* ROI_SECOND_PASS */
 
 static void DCMIPP_PipeInitDisplay(CMW_CameraInit_t *camConf)
 {
@@ -91,7 +117,7 @@ static void DCMIPP_PipeInitDisplay(CMW_CameraInit_t *camConf)
   }
 }
 
-static void DCMIPP_PipeInitNn(void)
+static void DCMIPP_PipeInitNn(CMW_Manual_roi_area_t *roi)
 {
   CMW_Aspect_Ratio_Mode_t aspect_ratio;
   CMW_DCMIPP_Conf_t dcmipp_conf;
@@ -117,6 +143,32 @@ static void DCMIPP_PipeInitNn(void)
   dcmipp_conf.mode = aspect_ratio;
   dcmipp_conf.enable_swap = 1;
   dcmipp_conf.enable_gamma_conversion = GAMMA_CONVERSION;
+  if (roi != NULL)
+  {
+    dcmipp_conf.mode = CMW_Aspect_ratio_manual_roi;
+    dcmipp_conf.manual_conf = *roi;
+  }
+#if (ROI_SECOND_PASS == 1)
+  else
+  {
+    /* keep the full frame area to map the detections of the first pass */
+    DCMIPP_CropConfTypeDef crop = {0};
+    DCMIPP_DecimationConfTypeDef dec = {0};
+    DCMIPP_DownsizeTypeDef down = {0};
+
+    CMW_UTILS_GetPipeConfig(camWidth, camHeight, &dcmipp_conf, &crop, &dec, &down);
+    if (crop.HSize == 0)
+    {
+      /* no crop: the whole sensor is resized */
+      crop.HSize = camWidth;
+      crop.VSize = camHeight;
+    }
+    nnPipeFull.offset_x = crop.HStart;
+    nnPipeFull.offset_y = crop.VStart;
+    nnPipeFull.width = crop.HSize;
+    nnPipeFull.height = crop.VSize;
+  }
+#endif /* ROI_SECOND_PASS */
   uint32_t pitch;
   ret = CMW_CAMERA_SetPipeConfig(DCMIPP_PIPE2, &dcmipp_conf, &pitch);
   assert(ret == HAL_OK);
@@ -140,8 +192,12 @@ void CAM_Init(void)
 
   ret = CMW_CAMERA_Init(&cam_conf);
   assert(ret == CMW_ERROR_NONE);
+#if (ROI_SECOND_PASS == 1)
+  camWidth = cam_conf.width;
+  camHeight = cam_conf.height;
+#endif
   DCMIPP_PipeInitDisplay(&cam_conf);
-  DCMIPP_PipeInitNn();
+  DCMIPP_PipeInitNn(NULL);
 }
 
 void CAM_DeInit(void)
@@ -166,6 +222,227 @@ void CAM_NNPipe_Start(uint8_t *nn_pipe_dst, uint32_t cam_mode)
   assert(ret == CMW_ERROR_NONE);
 }
 
+#if (STREAMING_MODE == 1)
+/**
+  * @brief  Start continuous capture of the NN pipe in double buffer mode
+  * @param  nn_pipe_dst1 first capture buffer
+  * @param  nn_pipe_dst2 second capture buffer
+  * @param  cam_mode CMW_MODE_CONTINUOUS or CMW_MODE_SNAPSHOT
+  * @retval None
+  */
+void CAM_NNPipe_DoubleBufferStart(uint8_t *nn_pipe_dst1, uint8_t *nn_pipe_dst2, uint32_t cam_mode)
+{
+  int ret;
+
+  nnPipeBuffers[0] = nn_pipe_dst1;
+  nnPipeBuffers[1] = nn_pipe_dst2;
+  nnPipeReadyIdx = -1;
+  nnPipeLockedIdx = -1;
+  nnPipeSuspended = 0;
+  nnPipeSuspends = 0;
+  nnPipeDrops = 0;
+
+  if (HAL_DCMIPP_PIPE_GetState(CMW_CAMERA_GetDCMIPPHandle(), DCMIPP_PIPE2) == HAL_DCMIPP_PIPE_STATE_SUSPEND)
+  {
+    /* warm restart: the pipe keeps its buffers and its position in the double buffer sequence */
+    nnPipeFramesBase = nnPipeFrames;
+    ret = CMW_CAMERA_Resume(DCMIPP_PIPE2);
+  }
+  else
+  {
+    nnPipeFrames = 0;
+    nnPipeFramesBase = 0;
+    ret = CMW_CAMERA_DoubleBufferStart(DCMIPP_PIPE2, nn_pipe_dst1, nn_pipe_dst2, cam_mode);
+  }
+  assert(ret == CMW_ERROR_NONE);
+}
+
+/**
+  * @brief  Take the last completed NN pipe frame, it stays locked until CAM_NNPipe_ReleaseFrame
+  * @param  None
+  * @retval pointer to the frame, NULL if no new frame is available
+  */
+uint8_t *CAM_NNPipe_GetFrame(void)
+{
+  uint8_t *frame = NULL;
+
+  __disable_irq();
+  if (nnPipeReadyIdx >= 0)
+  {
+    nnPipeLockedIdx = nnPipeReadyIdx;
+    nnPipeReadyIdx = -1;
+    frame = nnPipeBuffers[nnPipeLockedIdx];
+  }
+  __enable_irq();
+
+  return frame;
+}
+
+/**
+  * @brief  Release the frame taken by CAM_NNPipe_GetFrame and resume the pipe if it was held
+  * @param  None
+  * @retval None
+  */
+void CAM_NNPipe_ReleaseFrame(void)
+{
+  int32_t suspended;
+  int ret;
+
+  __disable_irq();
+  nnPipeLockedIdx = -1;
+  suspended = nnPipeSuspended;
+  nnPipeSuspended = 0;
+  __enable_irq();
+
+  if (suspended)
+  {
+    /* the pipe is stopped since the frame end, the HAL suspend does not wait for the capture
+     * and both calls run in thread context with the tick running */
+    ret = CMW_CAMERA_Suspend(DCMIPP_PIPE2);
+    assert(ret == CMW_ERROR_NONE);
+    ret = CMW_CAMERA_Resume(DCMIPP_PIPE2);
+    assert(ret == CMW_ERROR_NONE);
+  }
+}
+
+/**
+  * @brief  Get NN pipe streaming counters
+  * @param  stats pointer to the counters to fill
+  * @retval None
+  */
+void CAM_NNPipe_GetStats(CAM_NNPipeStats_t *stats)
+{
+  stats->frames = nnPipeFrames - nnPipeFramesBase;
+  stats->suspends = nnPipeSuspends;
+  stats->drops = nnPipeDrops;
+}
+
+/**
+  * @brief  NN pipe frame completed in double buffer mode (DCMIPP IRQ context)
+  * @param  None
+  * @retval None
+  */
+static void CAM_NNPipe_FrameDone(void)
+{
+  /* the pipe starts on the first buffer and then alternates */
+  int32_t done = nnPipeFrames & 1;
+
+  nnPipeFrames++;
+  if (nnPipeReadyIdx >= 0)
+  {
+    /* previous frame not taken in time, superseded by this one */
+    nnPipeDrops++;
+  }
+  nnPipeReadyIdx = done;
+
+  /* next frame would land in the buffer read by the NPU: hold the pipe until it is released.
+   * Only the capture request is cleared here, the next frame is not started. The HAL suspend
+   * polls with a HAL_GetTick timeout while the tick may be suspended, it is done by
+   * CAM_NNPipe_ReleaseFrame in thread context. */
+  if (nnPipeLockedIdx == (done ^ 1))
+  {
+    CLEAR_BIT(CMW_CAMERA_GetDCMIPPHandle()->Instance->P2FCTCR, DCMIPP_P2FCTCR_CPTREQ);
+    nnPipeSuspended = 1;
+    nnPipeSuspends++;
+  }
+}
+#endif /* STREAMING_MODE */
+
+#if (ROI_SECOND_PASS == 1)
+/**
+  * @brief  Crop the NN pipe around a detection of the full frame. The ROI keeps the NN
+  *         input aspect ratio, it is ROI_SECOND_PASS_MARGIN percent of the box and never
+  *         smaller than the NN input, so small objects are captured at native resolution
+  * @param  x_center box center, normalized to the full frame NN input
+  * @param  y_center box center, normalized to the full frame NN input
+  * @param  width box width, normalized to the full frame NN input
+  * @param  height box height, normalized to the full frame NN input
+  * @retval None
+  */
+void CAM_NNPipe_SetRoi(float x_center, float y_center, float width, float height)
+{
+  CMW_Manual_roi_area_t full = nnPipeFull;
+  CMW_Manual_roi_area_t roi;
+  float size_w;
+  float size_h;
+
+  /* box in sensor coordinates, enlarged to the NN input aspect ratio */
+  size_w = width * full.width * ROI_SECOND_PASS_MARGIN / 100;
+  size_h = height * full.height * ROI_SECOND_PASS_MARGIN / 100;
+  if (size_h * NN_WIDTH > size_w * NN_HEIGHT)
+  {
+    size_w = size_h * NN_WIDTH / NN_HEIGHT;
+  }
+  if (size_w < NN_WIDTH)
+  {
+    size_w = NN_WIDTH;
+  }
+  if (size_w > full.width)
+  {
+    size_w = full.width;
+  }
+  roi.width = ((uint32_t) size_w) & ~1U;
+  roi.height = ((roi.width * NN_HEIGHT) / NN_WIDTH) & ~1U;
+  if (roi.height > full.height)
+  {
+    roi.height = full.height & ~1U;
+    roi.width = ((roi.height * NN_WIDTH) / NN_HEIGHT) & ~1U;
+  }
+
+  /* center the ROI on the box, inside the full frame area */
+  int32_t x = full.offset_x + (int32_t) (x_center * full.width) - roi.width / 2;
+  int32_t y = full.offset_y + (int32_t) (y_center * full.height) - roi.height / 2;
+  if (x > (int32_t) (full.offset_x + full.width - roi.width))
+  {
+    x = full.offset_x + full.width - roi.width;
+  }
+  if (x < (int32_t) full.offset_x)
+  {
+    x = full.offset_x;
+  }
+  if (y > (int32_t) (full.offset_y + full.height - roi.height))
+  {
+    y = full.offset_y + full.height - roi.height;
+  }
+  if (y < (int32_t) full.offset_y)
+  {
+    y = full.offset_y;
+  }
+  roi.offset_x = x & ~1;
+  roi.offset_y = y & ~1;
+
+  DCMIPP_PipeInitNn(&roi);
+  nnPipeRoi = roi;
+}
+
+/**
+  * @brief  Restore the full frame NN pipe configuration
+  * @param  None
+  * @retval None
+  */
+void CAM_NNPipe_ResetRoi(void)
+{
+  DCMIPP_PipeInitNn(NULL);
+}
+
+/**
+  * @brief  Get the last ROI applied by CAM_NNPipe_SetRoi in sensor coordinates, still
+  *         valid after CAM_NNPipe_ResetRoi
+  * @param  offset_x area left position
+  * @param  offset_y area top position
+  * @param  width area width
+  * @param  height area height
+  * @retval None
+  */
+void CAM_NNPipe_GetRoi(uint32_t *offset_x, uint32_t *offset_y, uint32_t *width, uint32_t *height)
+{
+  *offset_x = nnPipeRoi.offset_x;
+  *offset_y = nnPipeRoi.offset_y;
+  *width = nnPipeRoi.width;
+  *height = nnPipeRoi.height;
+}
+#endif /* ROI_SECOND_PASS */
+
 void CAM_DisplayPipe_Stop()
 {
   int ret;
@@ -173,6 +450,43 @@ void CAM_DisplayPipe_Stop()
   assert(ret == CMW_ERROR_NONE);
 }
 
+/**
+  * @brief  Put the sensor in standby and gate the camera pipeline clocks, the whole
+  *         configuration (sensor, ISP, CSI and DCMIPP) is kept for CAM_Sensor_Start
+  * @param  None
+  * @retval None
+  */
+void CAM_Sensor_Stop(void)
+{
+  int ret;
+
+  /* no-op for a completed snapshot, holds the pipe in continuous mode */
+  ret = CMW_CAMERA_Suspend(DCMIPP_PIPE2);
+  assert(ret == CMW_ERROR_NONE);
+  ret = CMW_CAMERA_SensorStop();
+  assert(ret == CMW_ERROR_NONE);
+
+  /* registers are retained while the clocks are gated */
+  __HAL_RCC_DCMIPP_CLK_DISABLE();
+  __HAL_RCC_CSI_CLK_DISABLE();
+}
+
+/**
+  * @brief  Wake-up the sensor from standby, no probe nor ISP initialization
+  * @param  None
+  * @retval None
+  */
+void CAM_Sensor_Start(void)
+{
+  int ret;
+
+  __HAL_RCC_DCMIPP_CLK_ENABLE();
+  __HAL_RCC_CSI_CLK_ENABLE();
+  HAL_NVIC_EnableIRQ(CSI_IRQn);
+  ret = CMW_CAMERA_SensorStart();
+  assert(ret == CMW_ERROR_NONE);
+}
+
 void CAM_IspUpdate(void)
 {
   int ret = CMW_ERROR_NONE;
@@ -191,6 +505,14 @@ int CMW_CAMERA_PIPE_FrameEventCallback(uint32_t pipe)
   {
     case DCMIPP_PIPE2 :
       cameraFrameReceived++;
+      cameraFrameTimestamp = pwr_timestamp_get();
+      SCHED_Post(SCHED_EVT_FRAME);
+#if (STREAMING_MODE == 1)
+      if (nnPipeBuffers[0] != NULL)
+      {
+        CAM_NNPipe_FrameDone();
+      }
+#endif
       break;
   }
   return 0;
@@ -0,0 +1,157 @@
+/**
+ ******************************************************************************
+ * @file    app_dvfs.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include "app_dvfs.h"
+#include "app_config.h"
+
+#if (DVFS_CALIBRATION == 1) || (DVFS_OPERATING_POINT >= 0)
+
+/* HSE feeding the PLLs, in MHz */
+#define DVFS_HSE_FREQ       48
+/* NPU RAMs max frequency in nominal and overdrive voltage, in MHz */
+#define DVFS_RAMS_MAX_FREQ  800
+#define DVFS_RAMS_MAX_FREQ_OVERDRIVE 900
+
+static FrequencyStep dvfsPoints[DVFS_MAX_OPERATING_POINTS];
+static char dvfsNames[DVFS_MAX_OPERATING_POINTS][32];
+static uint32_t dvfsNbPoints;
+
+/**
+  * @brief  Output frequency of a PLL fed by HSE
+  * @param  cfg PLL configuration
+  * @retval frequency in MHz
+  */
+static uint32_t pllFreq(const RCC_PLLInitTypeDef *cfg)
+{
+  return DVFS_HSE_FREQ * cfg->PLLN / cfg->PLLM / cfg->PLLP1 / cfg->PLLP2;
+}
+
+/**
+  * @brief  Frequency of an IC clock source of a step, PLL1 being at 800MHz
+  * @param  step frequency step
+  * @param  src IC clock source
+  * @retval frequency in MHz
+  */
+static uint32_t srcFreq(const FrequencyStep *step, uint32_t src)
+{
+  if (src == RCC_ICCLKSOURCE_PLL2)
+  {
+    return pllFreq(&step->pll2Cfg);
+  }
+  if (src == RCC_ICCLKSOURCE_PLL3)
+  {
+    return pllFreq(&step->pll3Cfg);
+  }
+  return 800;
+}
+
+/**
+  * @brief  Append an operating point and build its timestamp step name
+  * @param  base frequency step giving the PLLs and the NPU clock
+  * @param  overdrive 1: VddCore in overdrive, 0: nominal
+  * @param  ramsClkSrc NPU RAMs clock source
+  * @param  cpuClkSrc CPU clock source
+  * @retval None
+  */
+static void addPoint(const FrequencyStep *base, uint32_t overdrive, uint32_t ramsClkSrc, uint32_t cpuClkSrc)
+{
+  FrequencyStep *point = &dvfsPoints[dvfsNbPoints];
+
+  assert(dvfsNbPoints < DVFS_MAX_OPERATING_POINTS);
+  *point = *base;
+  point->overdrive = overdrive;
+  point->npuRamsClkSrc = ramsClkSrc;
+  point->cpuClkSrc = cpuClkSrc;
+  snprintf(dvfsNames[dvfsNbPoints], sizeof(dvfsNames[0]), "op%02lu %s n%lu r%lu c%lu",
+           dvfsNbPoints, overdrive ? "OD" : "NOM", point->npufreq,
+           srcFreq(point, ramsClkSrc), srcFreq(point, cpuClkSrc));
+  point->stepName = dvfsNames[dvfsNbPoints];
+  sysclk_NpuFreqScalingPrepare(point);
+  dvfsNbPoints++;
+}
+
+/**
+  * @brief  Build the operating points from the frequency steps
+  * @param  steps frequency steps, one per NPU clock
+  * @param  nbSteps number of frequency steps
+  * @retval None
+  * @note   each nominal step is declined with NPU RAMs clocked from the NPU PLL or
+  *         from PLL3, and in overdrive with the CPU clocked from PLL3 or PLL1.
+  *         Overdrive steps are kept as is. Points are grouped per voltage so that
+  *         the sweep changes the SMPS output only once. The order only depends on
+  *         the steps, an index of the calibration is thus valid in later builds.
+  */
+void DVFS_Init(const FrequencyStep *steps, uint32_t nbSteps)
+{
+  dvfsNbPoints = 0;
+
+  for (uint32_t overdrive = 0; overdrive < 2; overdrive++)
+  {
+    uint32_t ramsMax = overdrive ? DVFS_RAMS_MAX_FREQ_OVERDRIVE : DVFS_RAMS_MAX_FREQ;
+
+    for (uint32_t i = 0; i < nbSteps; i++)
+    {
+      const FrequencyStep *step = &steps[i];
+
+      if (step->overdrive)
+      {
+        if (overdrive)
+        {
+          addPoint(step, 1, step->npuRamsClkSrc, step->cpuClkSrc);
+        }
+        continue;
+      }
+
+      for (uint32_t cpu = 0; cpu <= overdrive; cpu++)
+      {
+        uint32_t cpuClkSrc = cpu ? RCC_ICCLKSOURCE_PLL1 : RCC_ICCLKSOURCE_PLL3;
+
+        addPoint(step, overdrive, RCC_ICCLKSOURCE_PLL2, cpuClkSrc);
+        /* NPU RAMs on PLL3, skipped when it does not change their clock */
+        if ((pllFreq(&step->pll3Cfg) != step->npufreq) && (pllFreq(&step->pll3Cfg) <= ramsMax))
+        {
+          addPoint(step, overdrive, RCC_ICCLKSOURCE_PLL3, cpuClkSrc);
+        }
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Number of operating points built by DVFS_Init
+  * @retval number of operating points
+  */
+uint32_t DVFS_GetNbOperatingPoints(void)
+{
+  return dvfsNbPoints;
+}
+
+/**
+  * @brief  Operating point of the calibration sweep
+  * @param  index operating point index
+  * @retval operating point
+  */
+const FrequencyStep *DVFS_GetOperatingPoint(uint32_t index)
+{
+  assert(index < dvfsNbPoints);
+  return &dvfsPoints[index];
+}
+
+#endif /* DVFS_CALIBRATION || DVFS_OPERATING_POINT */
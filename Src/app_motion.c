@@ -0,0 +1,92 @@
+ /**
+ ******************************************************************************
+ * @file    app_motion.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "app_motion.h"
+#include "app_config.h"
+
+/* pixels sampled in each direction inside a cell, keeps the cpu work small */
+#define MOTION_CELL_SAMPLES 4
+
+/* luminance of the frame used for the last inference, and of the current frame */
+static uint8_t motionRef[MOTION_GRID * MOTION_GRID];
+static uint8_t motionCur[MOTION_GRID * MOTION_GRID];
+static int motionRefValid;
+
+/**
+  * @brief  Build the luminance thumbnail of a frame and compare it to the reference
+  * @param  frame RGB frame, must be invalidated from data cache by the caller
+  * @param  width frame width
+  * @param  height frame height
+  * @param  bpp bytes per pixel, first three bytes are the color components
+  * @retval number of cells whose luminance differs by more than MOTION_GATE_CELL_DIFF,
+  *         MOTION_GRID * MOTION_GRID when no reference is available
+  */
+uint32_t MOTION_Score(const uint8_t *frame, uint32_t width, uint32_t height, uint32_t bpp)
+{
+  const uint32_t cell_w = width / MOTION_GRID;
+  const uint32_t cell_h = height / MOTION_GRID;
+  uint32_t score = 0;
+
+  assert(bpp >= 3);
+  assert((cell_w >= MOTION_CELL_SAMPLES) && (cell_h >= MOTION_CELL_SAMPLES));
+
+  for (uint32_t cy = 0; cy < MOTION_GRID; cy++)
+  {
+    for (uint32_t cx = 0; cx < MOTION_GRID; cx++)
+    {
+      uint32_t sum = 0;
+
+      for (uint32_t sy = 0; sy < MOTION_CELL_SAMPLES; sy++)
+      {
+        uint32_t y = cy * cell_h + (sy * cell_h) / MOTION_CELL_SAMPLES;
+        const uint8_t *line = &frame[(y * width + cx * cell_w) * bpp];
+
+        for (uint32_t sx = 0; sx < MOTION_CELL_SAMPLES; sx++)
+        {
+          const uint8_t *p = &line[((sx * cell_w) / MOTION_CELL_SAMPLES) * bpp];
+          /* (R + 2G + B) / 4, independent of the R/B order */
+          sum += (p[0] + 2 * p[1] + p[2]) >> 2;
+        }
+      }
+
+      uint32_t idx = cy * MOTION_GRID + cx;
+      motionCur[idx] = sum / (MOTION_CELL_SAMPLES * MOTION_CELL_SAMPLES);
+      int32_t diff = (int32_t) motionCur[idx] - (int32_t) motionRef[idx];
+      if ((diff > MOTION_GATE_CELL_DIFF) || (diff < -MOTION_GATE_CELL_DIFF))
+      {
+        score++;
+      }
+    }
+  }
+
+  return motionRefValid ? score : MOTION_GRID * MOTION_GRID;
+}
+
+/**
+  * @brief  Use the last scored frame as reference. The reference is only updated when
+  *         the inference runs, so slow changes accumulate until they open the gate
+  * @param  None
+  * @retval None
+  */
+void MOTION_SetReference(void)
+{
+  memcpy(motionRef, motionCur, sizeof(motionRef));
+  motionRefValid = 1;
+}
@@ -0,0 +1,469 @@
+ /**
+ ******************************************************************************
+ * @file    app_nn.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2024 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include <assert.h>
+#include "app_nn.h"
+#include "app_config.h"
+#if (NN_EPOCH_TRACE == 1)
+#include <stdio.h>
+#include <string.h>
+#include "pwr_timestamp.h"
+#endif
+#if (NPU_PROFILE != NPU_PROFILE_NONE)
+#include "app_npu_profile.h"
+#endif
+#if (NN_EPOCH_FREQ_PLAN == 1)
+#include "app_npu_freq_plan.h"
+#endif
+#if (CPU_FRQ_SCALE_DOWN_ADAPTIVE == 1)
+#include "app_npu_wfe.h"
+#endif
+#if (NN_CACHE_CHECK == 1)
+#include <stdio.h>
+#include "stm32n6xx_hal.h"
+#endif
+
+/* epoch block callback used by the epoch trace, the NPU profiling, the frequency plan and
+ * the adaptive CPU clock */
+#define NN_EPOCH_CALLBACK ((NN_EPOCH_TRACE == 1) || (NPU_PROFILE != NPU_PROFILE_NONE) || \
+                           (NN_EPOCH_FREQ_PLAN == 1) || (CPU_FRQ_SCALE_DOWN_ADAPTIVE == 1))
+
+#if (NN_PERSISTENT_RUNTIME == 1)
+#define NN_MAX_INSTANCES 2
+
+/* network instances kept initialized between inferences (runtime is shared) */
+static NN_Instance_TypeDef *nnInitializedInstances[NN_MAX_INSTANCES];
+static int nnNbInitialized;
+#endif
+
+/* inference started by NN_Start, completed by NN_Poll (the NPU runs one network at a time) */
+static NN_Instance_TypeDef *nnAsyncInstance;
+static NN_DoneCallback_t nnAsyncDone;
+static void *nnAsyncArg;
+
+#if (NN_CACHE_CHECK == 1)
+/* cache maintenance check of the generated schedule */
+static const char *nnCacheCheckNetwork;
+static uint32_t nnCacheCheckBlocks[3]; /* hw, sw and hybrid epoch blocks of the schedule */
+static uint32_t nnCacheChecks;
+static uint32_t nnCacheMismatches;
+#endif
+
+#if NN_EPOCH_CALLBACK
+#define NN_EPOCH_TRACE_NETWORKS 2
+#define NN_EPOCH_TRACE_NAME_LEN 32
+
+/* epoch blocks of a network and their timestamp step names, built once: pwr_timestamp_log
+ * keeps the name pointer until the log is sent */
+typedef struct
+{
+  const EpochBlock_ItemTypeDef *items;
+  uint32_t nbBlocks;
+#if (NN_EPOCH_TRACE == 1)
+  char names[NN_EPOCH_TRACE_MAX_BLOCKS][2][NN_EPOCH_TRACE_NAME_LEN];
+#endif
+} NN_EpochTrace_t;
+
+static NN_EpochTrace_t nnEpochTrace[NN_EPOCH_TRACE_NETWORKS];
+static uint32_t nnNbEpochTrace;
+
+/**
+  * @brief  Find the epoch block names of a network
+  * @param  items epoch block list of the network
+  * @retval names of the network, NULL if not built yet
+  */
+static NN_EpochTrace_t *epochTraceFind(const EpochBlock_ItemTypeDef *items)
+{
+  for (uint32_t i = 0; i < nnNbEpochTrace; i++)
+  {
+    if (nnEpochTrace[i].items == items)
+    {
+      return &nnEpochTrace[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief  Build the step names of the epoch blocks of a network:
+  *         "[network ]eb<index> <start|end> <hw|sw|hyb>[ e<first epoch>-<last epoch>]",
+  *         the network is omitted for the default one and the epoch range is only known
+  *         when the network is generated with LL_ATON_EB_DBG_INFO
+  * @param  nn_instance network instance
+  * @retval None
+  */
+static void epochTraceSetup(NN_Instance_TypeDef *nn_instance)
+{
+  const EpochBlock_ItemTypeDef *items = nn_instance->network->epoch_block_items();
+  const char *network = nn_instance->network->network_name;
+  NN_EpochTrace_t *trace;
+
+  if (epochTraceFind(items))
+  {
+    return;
+  }
+  assert(nnNbEpochTrace < NN_EPOCH_TRACE_NETWORKS);
+#if (NPU_PROFILE != NPU_PROFILE_NONE)
+  NPU_PROFILE_SetNetworkName(nnNbEpochTrace, network);
+#endif
+#if (NN_EPOCH_FREQ_PLAN == 1)
+  NPU_FREQ_PLAN_SetNetwork(nnNbEpochTrace, network);
+#endif
+#if (CPU_FRQ_SCALE_DOWN_ADAPTIVE == 1)
+  NPU_WFE_SetNetworkName(nnNbEpochTrace, network);
+#endif
+  trace = &nnEpochTrace[nnNbEpochTrace++];
+  trace->items = items;
+
+  for (trace->nbBlocks = 0; trace->nbBlocks < NN_EPOCH_TRACE_MAX_BLOCKS; trace->nbBlocks++)
+  {
+    const EpochBlock_ItemTypeDef *eb = &items[trace->nbBlocks];
+
+    if (EpochBlock_IsLastEpochBlock(eb))
+    {
+      break;
+    }
+#if (NN_EPOCH_TRACE == 1)
+    static const char *const event[2] = {"start", "end"};
+    const char *kind = EpochBlock_IsEpochPureHW(eb) ? "hw" : EpochBlock_IsEpochPureSW(eb) ? "sw" : "hyb";
+    for (int e = 0; e < 2; e++)
+    {
+      char *name = trace->names[trace->nbBlocks][e];
+      int len = 0;
+
+      if (strcmp(network, "Default") != 0)
+      {
+        len = snprintf(name, NN_EPOCH_TRACE_NAME_LEN, "%.12s ", network);
+      }
+      len += snprintf(&name[len], NN_EPOCH_TRACE_NAME_LEN - len, "eb%lu %s %s",
+                      trace->nbBlocks, event[e], kind);
+#ifdef LL_ATON_EB_DBG_INFO
+      snprintf(&name[len], NN_EPOCH_TRACE_NAME_LEN - len, " e%d-%d", eb->epoch_num, eb->last_epoch_num);
+#endif
+    }
+#endif /* NN_EPOCH_TRACE */
+  }
+}
+
+/**
+  * @brief  Epoch block callback, logs the start and the end of the epoch blocks of the
+  *         network, profiles them, applies their NPU clocks and follows the block running
+  *         on the NPU for the adaptive CPU clock. Internal blocks inserted by the runtime for hybrid
+  *         epochs are part of their hybrid epoch block and are not logged
+  * @param  ctype callback type
+  * @param  nn_instance network instance
+  * @param  epoch_block epoch block
+  * @retval None
+  */
+static void epochTraceCallback(LL_ATON_RT_Callbacktype_t ctype, const NN_Instance_TypeDef *nn_instance,
+                               const EpochBlock_ItemTypeDef *epoch_block)
+{
+  NN_EpochTrace_t *trace;
+  uint32_t block;
+
+  trace = epochTraceFind(nn_instance->network->epoch_block_items());
+  if ((trace == NULL) || (epoch_block < trace->items) || (epoch_block >= &trace->items[trace->nbBlocks]))
+  {
+    return;
+  }
+  block = epoch_block - trace->items;
+
+#if (CPU_FRQ_SCALE_DOWN_ADAPTIVE == 1)
+  /* block running on the NPU between its start and its end */
+  if (ctype == LL_ATON_RT_Callbacktype_POST_START)
+  {
+    NPU_WFE_EpochStart(trace - nnEpochTrace, block, epoch_block);
+  }
+  else if (ctype == LL_ATON_RT_Callbacktype_PRE_END)
+  {
+    NPU_WFE_EpochEnd(trace - nnEpochTrace, block);
+  }
+#endif
+
+  if (ctype == LL_ATON_RT_Callbacktype_PRE_START)
+  {
+#if (NN_EPOCH_FREQ_PLAN == 1)
+    /* clock switch accounted between blocks, before the block start is logged */
+    NPU_FREQ_PLAN_EpochStart(trace - nnEpochTrace, block);
+#endif
+#if (NN_EPOCH_TRACE == 1)
+    pwr_timestamp_log(trace->names[block][0]);
+#endif
+#if (NPU_PROFILE != NPU_PROFILE_NONE)
+    NPU_PROFILE_EpochStart(trace - nnEpochTrace, block, epoch_block);
+#endif
+  }
+  else if (ctype == LL_ATON_RT_Callbacktype_POST_END)
+  {
+#if (NPU_PROFILE != NPU_PROFILE_NONE)
+    NPU_PROFILE_EpochEnd(trace - nnEpochTrace, block, epoch_block);
+#endif
+#if (NN_EPOCH_TRACE == 1)
+    pwr_timestamp_log(trace->names[block][1]);
+#endif
+  }
+}
+#endif /* NN_EPOCH_CALLBACK */
+
+/**
+  * @brief  Get the network instance ready for a new inference. In persistent mode the
+  *         runtime and the network are initialized at first call only, next calls only
+  *         reset the instance (blob relocation is redone at start of inference).
+  * @param  nn_instance network instance
+  * @retval None
+  */
+void NN_Prepare(NN_Instance_TypeDef *nn_instance)
+{
+#if (NN_PERSISTENT_RUNTIME == 1)
+  for (int i = 0; i < nnNbInitialized; i++)
+  {
+    if (nnInitializedInstances[i] == nn_instance)
+    {
+      LL_ATON_RT_Reset_Network(nn_instance);
+      return;
+    }
+  }
+  assert(nnNbInitialized < NN_MAX_INSTANCES);
+  if (nnNbInitialized == 0)
+  {
+    LL_ATON_RT_RuntimeInit();
+  }
+  nnInitializedInstances[nnNbInitialized++] = nn_instance;
+#else
+  LL_ATON_RT_RuntimeInit();
+#endif
+#if NN_EPOCH_CALLBACK
+  epochTraceSetup(nn_instance);
+  LL_ATON_RT_SetEpochCallback(epochTraceCallback, nn_instance);
+#endif
+  LL_ATON_RT_Init_Network(nn_instance);
+}
+
+/**
+  * @brief  End of inference, runtime and network are de-initialized unless persistent mode is enabled
+  * @param  nn_instance network instance
+  * @retval None
+  */
+void NN_Release(NN_Instance_TypeDef *nn_instance)
+{
+#if (NN_EPOCH_FREQ_PLAN == 1)
+  NN_EpochTrace_t *trace = epochTraceFind(nn_instance->network->epoch_block_items());
+
+  if (trace != NULL)
+  {
+    NPU_FREQ_PLAN_End(trace - nnEpochTrace, trace->nbBlocks);
+  }
+#endif
+#if (NN_PERSISTENT_RUNTIME == 0)
+  LL_ATON_RT_DeInit_Network(nn_instance);
+  LL_ATON_RT_RuntimeDeInit();
+#else
+  (void) nn_instance;
+#endif
+}
+
+/**
+  * @brief  Start an asynchronous inference: prepares the network and runs the epoch blocks up
+  *         to the first hardware epoch. The inference is completed by calls to NN_Poll
+  * @param  nn_instance network instance
+  * @param  done completion callback called by NN_Poll (can be NULL)
+  * @param  arg argument of the completion callback
+  * @retval None
+  */
+void NN_Start(NN_Instance_TypeDef *nn_instance, NN_DoneCallback_t done, void *arg)
+{
+  assert(nnAsyncInstance == NULL);
+
+  NN_Prepare(nn_instance);
+  nnAsyncInstance = nn_instance;
+  nnAsyncDone = done;
+  nnAsyncArg = arg;
+}
+
+/**
+  * @brief  Run the epoch blocks of a started inference until the NPU runs a hardware epoch or
+  *         the inference ends. On NN_POLL_BUSY the CPU is free until the next NPU event
+  *         (ATON_STD_IRQHandler), on NN_POLL_DONE the network is released and the completion
+  *         callback has been called
+  * @param  nn_instance network instance
+  * @retval NN_POLL_BUSY or NN_POLL_DONE
+  */
+NN_PollStatus_t NN_Poll(NN_Instance_TypeDef *nn_instance)
+{
+  LL_ATON_RT_RetValues_t ret;
+  NN_DoneCallback_t done = nnAsyncDone;
+
+  assert(nn_instance == nnAsyncInstance);
+
+  do
+  {
+    ret = LL_ATON_RT_RunEpochBlock(nn_instance);
+  } while (ret == LL_ATON_RT_NO_WFE);
+
+  if (ret == LL_ATON_RT_WFE)
+  {
+    return NN_POLL_BUSY;
+  }
+
+  NN_Release(nn_instance);
+  nnAsyncInstance = NULL;
+  if (done != NULL)
+  {
+    done(nn_instance, nnAsyncArg);
+  }
+
+  return NN_POLL_DONE;
+}
+
+/**
+  * @brief  Run one inference, CPU waits for NPU events during hardware epochs
+  * @param  nn_instance network instance
+  * @retval None
+  */
+void NN_Run(NN_Instance_TypeDef *nn_instance)
+{
+  NN_Start(nn_instance, NULL, NULL);
+  while (NN_Poll(nn_instance) == NN_POLL_BUSY)
+  {
+    LL_ATON_OSAL_WFE();
+  }
+}
+
+/**
+  * @brief  De-initialize network and runtime kept by persistent mode
+  * @param  nn_instance network instance
+  * @retval None
+  */
+void NN_DeInit(NN_Instance_TypeDef *nn_instance)
+{
+#if (NN_PERSISTENT_RUNTIME == 1)
+  for (int i = 0; i < nnNbInitialized; i++)
+  {
+    if (nnInitializedInstances[i] == nn_instance)
+    {
+      LL_ATON_RT_DeInit_Network(nn_instance);
+      nnInitializedInstances[i] = nnInitializedInstances[--nnNbInitialized];
+      if (nnNbInitialized == 0)
+      {
+        LL_ATON_RT_RuntimeDeInit();
+      }
+      break;
+    }
+  }
+#else
+  (void) nn_instance;
+#endif
+}
+
+#if (NN_CACHE_CHECK == 1)
+/**
+  * @brief  Checksum (FNV-1a) of the output buffers of a network, read through the D-cache
+  * @param  nn_instance network instance
+  * @retval checksum
+  */
+static uint32_t outputsChecksum(NN_Instance_TypeDef *nn_instance)
+{
+  const LL_Buffer_InfoTypeDef *buffers = nn_instance->network->output_buffers_info();
+  uint32_t hash = 2166136261U;
+
+  for (; buffers->name != NULL; buffers++)
+  {
+    const uint8_t *data = (const uint8_t *) LL_Buffer_addr_start(buffers);
+
+    for (uint32_t i = 0; i < LL_Buffer_len(buffers); i++)
+    {
+      hash = (hash ^ data[i]) * 16777619U;
+    }
+  }
+
+  return hash;
+}
+
+/**
+  * @brief  Check the cache maintenance of the generated schedule: the outputs of the last
+  *         inference, read as the application reads them, are compared with the outputs of a
+  *         reference inference run on the same inputs with the whole D-cache cleaned and
+  *         invalidated between epoch blocks. A mismatch means a software epoch read stale
+  *         NPU results or the NPU read CPU results still in the D-cache
+  * @param  nn_instance network instance, its inputs must be unchanged since the last inference
+  * @retval 1 if the outputs match, 0 otherwise
+  */
+int NN_CacheCheck(NN_Instance_TypeDef *nn_instance)
+{
+  const EpochBlock_ItemTypeDef *eb = nn_instance->network->epoch_block_items();
+  uint32_t scheduled = outputsChecksum(nn_instance);
+  LL_ATON_RT_RetValues_t ret;
+
+  nnCacheCheckNetwork = nn_instance->network->network_name;
+  for (int i = 0; i < 3; i++)
+  {
+    nnCacheCheckBlocks[i] = 0;
+  }
+  for (; !EpochBlock_IsLastEpochBlock(eb); eb++)
+  {
+    nnCacheCheckBlocks[EpochBlock_IsEpochPureHW(eb) ? 0 : EpochBlock_IsEpochPureSW(eb) ? 1 : 2]++;
+  }
+
+  NN_Prepare(nn_instance);
+  /* reference run is not part of the epoch traces and profiles */
+  LL_ATON_RT_SetEpochCallback(NULL, nn_instance);
+  do
+  {
+    SCB_CleanInvalidateDCache();
+    ret = LL_ATON_RT_RunEpochBlock(nn_instance);
+    if (ret == LL_ATON_RT_WFE)
+    {
+      LL_ATON_OSAL_WFE();
+    }
+  } while (ret != LL_ATON_RT_DONE);
+  SCB_CleanInvalidateDCache();
+  NN_Release(nn_instance);
+#if NN_EPOCH_CALLBACK
+  /* the persistent runtime does not register the callback again in NN_Prepare */
+  LL_ATON_RT_SetEpochCallback(epochTraceCallback, nn_instance);
+#endif
+
+  nnCacheChecks++;
+  if (outputsChecksum(nn_instance) != scheduled)
+  {
+    nnCacheMismatches++;
+    return 0;
+  }
+
+  return 1;
+}
+
+/**
+  * @brief  Send the cache maintenance checks of the sequence over UART, with the NPU
+  *         profile records, then reset them
+  * @retval None
+  */
+void NN_CacheCheckReport(void)
+{
+  if (nnCacheChecks == 0)
+  {
+    return;
+  }
+  printf("[NPU_SOL]cache_check=%s:hw_blocks=%lu:sw_blocks=%lu:hyb_blocks=%lu:checks=%lu:mismatches=%lu[NPU_EOL]\r\n",
+         nnCacheCheckNetwork, nnCacheCheckBlocks[0], nnCacheCheckBlocks[1], nnCacheCheckBlocks[2],
+         nnCacheChecks, nnCacheMismatches);
+  nnCacheChecks = 0;
+  nnCacheMismatches = 0;
+}
+#endif /* NN_CACHE_CHECK */
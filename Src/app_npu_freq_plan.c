@@ -0,0 +1,180 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_freq_plan.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "app_npu_freq_plan.h"
+#include "app_config.h"
+#include "nn_freq_plan.h"
+#include "pwr_timestamp.h"
+#include "system_clock.h"
+
+#if (NN_EPOCH_FREQ_PLAN == 1)
+/* IC dividers range */
+#define NPU_FREQ_PLAN_MAX_DIV 256
+
+typedef struct
+{
+  const char *network;
+  uint32_t block;
+  uint32_t npuDiv;
+  uint32_t ramsDiv;
+} NPU_FREQ_PLAN_Entry_t;
+
+/* switches done at the start of an epoch block, the block following the last one
+ * counts the restore of the inference clocks */
+typedef struct
+{
+  uint32_t switches;
+  uint32_t ns;
+} NPU_FREQ_PLAN_Switch_t;
+
+static const NPU_FREQ_PLAN_Entry_t npuFreqPlan[] = { NN_FREQ_PLAN { NULL, 0, 1, 1 } };
+
+/* dividers of each epoch block relative to the inference clocks, 0 if the block has no entry */
+static uint8_t planDiv[NPU_FREQ_PLAN_NETWORKS][NN_EPOCH_TRACE_MAX_BLOCKS][2];
+static NPU_FREQ_PLAN_Switch_t planSwitch[NPU_FREQ_PLAN_NETWORKS][NN_EPOCH_TRACE_MAX_BLOCKS + 1];
+static const char *planName[NPU_FREQ_PLAN_NETWORKS];
+
+/* dividers of the inference clocks and current dividers relative to them */
+static uint32_t planBaseDiv[2];
+static uint32_t planCurDiv[2];
+static uint32_t planActive;
+
+/**
+  * @brief  Apply dividers relative to the inference clocks and measure the switch
+  * @param  stats switch statistics to update
+  * @param  npuDiv NPU clock divider
+  * @param  ramsDiv NPU RAMs clock divider
+  * @retval None
+  */
+static void planSwitchTo(NPU_FREQ_PLAN_Switch_t *stats, uint32_t npuDiv, uint32_t ramsDiv)
+{
+  uint32_t start = pwr_timestamp_get_ns();
+
+  sysclk_NpuSetClockDividers(planBaseDiv[0] * npuDiv, planBaseDiv[1] * ramsDiv);
+  planCurDiv[0] = npuDiv;
+  planCurDiv[1] = ramsDiv;
+
+  stats->ns += pwr_timestamp_get_ns() - start;
+  stats->switches++;
+}
+
+/**
+  * @brief  Load the entries of the frequency plan of a network
+  * @param  network network slot
+  * @param  name network name, as given by the frequency plan entries
+  * @retval None
+  */
+void NPU_FREQ_PLAN_SetNetwork(uint32_t network, const char *name)
+{
+  assert(network < NPU_FREQ_PLAN_NETWORKS);
+  planName[network] = name;
+  memset(planDiv[network], 0, sizeof(planDiv[network]));
+
+  for (int i = 0; npuFreqPlan[i].network != NULL; i++)
+  {
+    const NPU_FREQ_PLAN_Entry_t *entry = &npuFreqPlan[i];
+
+    if ((strcmp(entry->network, name) != 0) || (entry->block >= NN_EPOCH_TRACE_MAX_BLOCKS))
+    {
+      continue;
+    }
+    assert((entry->npuDiv > 0) && (entry->npuDiv <= NPU_FREQ_PLAN_MAX_DIV));
+    assert((entry->ramsDiv > 0) && (entry->ramsDiv <= NPU_FREQ_PLAN_MAX_DIV));
+    planDiv[network][entry->block][0] = entry->npuDiv;
+    planDiv[network][entry->block][1] = entry->ramsDiv;
+  }
+}
+
+/**
+  * @brief  Switch the NPU clocks of the epoch block before its start
+  * @param  network network slot
+  * @param  block epoch block index in the network
+  * @retval None
+  */
+void NPU_FREQ_PLAN_EpochStart(uint32_t network, uint32_t block)
+{
+  const uint8_t *div = planDiv[network][block];
+
+  if (div[0] == 0)
+  {
+    return;
+  }
+  if (!planActive)
+  {
+    /* first switch of the inference, keep its clocks */
+    sysclk_NpuGetClockDividers(&planBaseDiv[0], &planBaseDiv[1]);
+    assert(planBaseDiv[0] * div[0] <= NPU_FREQ_PLAN_MAX_DIV);
+    assert(planBaseDiv[1] * div[1] <= NPU_FREQ_PLAN_MAX_DIV);
+    planCurDiv[0] = 1;
+    planCurDiv[1] = 1;
+    planActive = 1;
+  }
+  if ((div[0] != planCurDiv[0]) || (div[1] != planCurDiv[1]))
+  {
+    planSwitchTo(&planSwitch[network][block], div[0], div[1]);
+  }
+}
+
+/**
+  * @brief  Restore the clocks of the inference at the end of the network
+  * @param  network network slot
+  * @param  nbBlocks number of epoch blocks of the network
+  * @retval None
+  */
+void NPU_FREQ_PLAN_End(uint32_t network, uint32_t nbBlocks)
+{
+  if (!planActive)
+  {
+    return;
+  }
+  if ((planCurDiv[0] != 1) || (planCurDiv[1] != 1))
+  {
+    planSwitchTo(&planSwitch[network][nbBlocks], 1, 1);
+  }
+  planActive = 0;
+}
+
+/**
+  * @brief  Send the clock switches of the sequence over UART, with the NPU profile
+  *         records, then reset them
+  * @retval None
+  */
+void NPU_FREQ_PLAN_Report(void)
+{
+  for (uint32_t n = 0; n < NPU_FREQ_PLAN_NETWORKS; n++)
+  {
+    for (uint32_t b = 0; b <= NN_EPOCH_TRACE_MAX_BLOCKS; b++)
+    {
+      NPU_FREQ_PLAN_Switch_t *stats = &planSwitch[n][b];
+      uint32_t npuDiv = (b < NN_EPOCH_TRACE_MAX_BLOCKS) && planDiv[n][b][0] ? planDiv[n][b][0] : 1;
+      uint32_t ramsDiv = (b < NN_EPOCH_TRACE_MAX_BLOCKS) && planDiv[n][b][1] ? planDiv[n][b][1] : 1;
+
+      if (stats->switches == 0)
+      {
+        continue;
+      }
+      printf("[NPU_SOL]network=%s:eb=%lu:npu_div=%lu:rams_div=%lu:switches=%lu:switch_ns=%lu[NPU_EOL]\r\n",
+             planName[n], b, npuDiv, ramsDiv, stats->switches, stats->ns);
+    }
+  }
+  memset(planSwitch, 0, sizeof(planSwitch));
+}
+#endif /* NN_EPOCH_FREQ_PLAN */
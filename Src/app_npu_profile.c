@@ -0,0 +1,210 @@
+ /**
+ ******************************************************************************
+ * @file    app_npu_profile.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "app_npu_profile.h"
+#include "app_config.h"
+#include "pwr_timestamp.h"
+
+#if (NPU_PROFILE != NPU_PROFILE_NONE)
+#include "ll_aton_dbgtrc.h"
+
+/* debug and trace unit of the NPU, 16 event counters */
+#define DBGTRC_ID        0
+#define DBGTRC_COUNTERS  16
+
+/* statistics of an epoch block, accumulated over the runs */
+typedef struct
+{
+  uint32_t runs;
+  const char *kind;
+  uint64_t ns;
+#if (NPU_PROFILE == NPU_PROFILE_TRANSFERS)
+  /* bytes read and written on each bus interface */
+  uint64_t rd[2];
+  uint64_t wr[2];
+#else
+  /* NPU cycles, cycles of the most active stream engine, sum over the active engines */
+  uint64_t cycles;
+  uint64_t activeMax;
+  uint64_t activeSum;
+  uint32_t engines;
+#endif
+} NPU_PROFILE_Block_t;
+
+static NPU_PROFILE_Block_t npuProfile[NPU_PROFILE_NETWORKS][NN_EPOCH_TRACE_MAX_BLOCKS];
+static const char *npuProfileName[NPU_PROFILE_NETWORKS];
+static uint32_t npuProfileStart;
+
+#if (NPU_PROFILE == NPU_PROFILE_TRANSFERS)
+/**
+  * @brief  Bytes transferred by one direction of a bus interface
+  * @param  counters burst counters of lengths 1, 2, 4 and 8 beats of 8 bytes
+  * @retval bytes
+  */
+static uint32_t burstBytes(const unsigned int *counters)
+{
+  uint32_t beats = 0;
+
+  for (int i = 0; i < 4; i++)
+  {
+    beats += counters[i] << i;
+  }
+
+  return beats * 8;
+}
+#endif
+
+/**
+  * @brief  Configure and start the NPU counters before the start of an epoch block
+  * @param  network network slot
+  * @param  block epoch block index in the network
+  * @param  epoch_block epoch block
+  * @retval None
+  */
+void NPU_PROFILE_EpochStart(uint32_t network, uint32_t block, const EpochBlock_ItemTypeDef *epoch_block)
+{
+  (void) network;
+  (void) block;
+
+#if (NPU_PROFILE == NPU_PROFILE_TRANSFERS)
+  (void) epoch_block;
+  /* burst lengths of writes and reads on both bus interfaces */
+  LL_Dbgtrc_BurstLenBenchStart(0);
+#else
+  LL_Dbgtrc_Counter_InitTypdef cycles = {
+      .signal = DBGTRC_VDD,
+      .evt_type = DBGTRC_EVT_HI,
+      .int_disable = 1,
+  };
+
+  LL_Dbgtrc_Init(DBGTRC_ID);
+  LL_Dbgtrc_Counter_Init(DBGTRC_ID, 0, &cycles);
+  LL_Dbgtrc_Count_StrengActive_Config(epoch_block->in_streng_mask, epoch_block->out_streng_mask, 1);
+  LL_Dbgtrc_Counter_Start(DBGTRC_ID, 0);
+  LL_Dbgtrc_Count_StrengActive_Start(epoch_block->in_streng_mask, epoch_block->out_streng_mask, 1);
+#endif
+  npuProfileStart = pwr_timestamp_get_ns();
+}
+
+/**
+  * @brief  Stop the NPU counters after the end of an epoch block and accumulate them
+  * @param  network network slot
+  * @param  block epoch block index in the network
+  * @param  epoch_block epoch block
+  * @retval None
+  */
+void NPU_PROFILE_EpochEnd(uint32_t network, uint32_t block, const EpochBlock_ItemTypeDef *epoch_block)
+{
+  uint32_t ns = pwr_timestamp_get_ns() - npuProfileStart;
+  NPU_PROFILE_Block_t *stats;
+
+  assert(network < NPU_PROFILE_NETWORKS);
+  assert(block < NN_EPOCH_TRACE_MAX_BLOCKS);
+  stats = &npuProfile[network][block];
+
+#if (NPU_PROFILE == NPU_PROFILE_TRANSFERS)
+  unsigned int counters[DBGTRC_COUNTERS];
+
+  for (int i = 0; i < DBGTRC_COUNTERS; i++)
+  {
+    LL_Dbgtrc_Counter_Stop(DBGTRC_ID, i);
+  }
+  LL_Dbgtrc_BurstLenGet(0, counters);
+  /* busif 0 writes, busif 0 reads, busif 1 writes, busif 1 reads */
+  stats->wr[0] += burstBytes(&counters[0]);
+  stats->rd[0] += burstBytes(&counters[4]);
+  stats->wr[1] += burstBytes(&counters[8]);
+  stats->rd[1] += burstBytes(&counters[12]);
+#else
+  uint32_t streng = epoch_block->in_streng_mask | epoch_block->out_streng_mask;
+  uint32_t counter = 1;
+  uint32_t activeMax = 0;
+
+  LL_Dbgtrc_Counter_Stop(DBGTRC_ID, 0);
+  LL_Dbgtrc_Count_StrengActive_Stop(epoch_block->in_streng_mask, epoch_block->out_streng_mask, 1);
+  stats->cycles += LL_Dbgtrc_Counter_Read(DBGTRC_ID, 0);
+  for (int i = 0; i < ATON_STRENG_NUM; i++)
+  {
+    if (streng & (1 << i))
+    {
+      uint32_t active = LL_Dbgtrc_Counter_Read(DBGTRC_ID, counter++);
+      stats->activeSum += active;
+      activeMax = (active > activeMax) ? active : activeMax;
+      stats->engines++;
+    }
+  }
+  stats->activeMax += activeMax;
+#endif
+  LL_Dbgtrc_Deinit(DBGTRC_ID);
+
+  stats->kind = EpochBlock_IsEpochPureHW(epoch_block) ? "hw" : EpochBlock_IsEpochPureSW(epoch_block) ? "sw" : "hyb";
+  stats->ns += ns;
+  stats->runs++;
+}
+
+/**
+  * @brief  Name of a network slot, used in the report
+  * @param  network network slot
+  * @param  name network name
+  * @retval None
+  */
+void NPU_PROFILE_SetNetworkName(uint32_t network, const char *name)
+{
+  assert(network < NPU_PROFILE_NETWORKS);
+  npuProfileName[network] = name;
+}
+
+/**
+  * @brief  Send the statistics of the profiled epoch blocks over UART, averaged per run,
+  *         then reset them. The console must be configured
+  * @retval None
+  */
+void NPU_PROFILE_Report(void)
+{
+  for (uint32_t n = 0; n < NPU_PROFILE_NETWORKS; n++)
+  {
+    for (uint32_t b = 0; b < NN_EPOCH_TRACE_MAX_BLOCKS; b++)
+    {
+      NPU_PROFILE_Block_t *stats = &npuProfile[n][b];
+      uint32_t runs = stats->runs;
+
+      if (runs == 0)
+      {
+        continue;
+      }
+#if (NPU_PROFILE == NPU_PROFILE_TRANSFERS)
+      printf("[NPU_SOL]network=%s:eb=%lu:kind=%s:runs=%lu:ns=%lu:"
+             "rd0=%lu:wr0=%lu:rd1=%lu:wr1=%lu[NPU_EOL]\r\n",
+             npuProfileName[n], b, stats->kind, runs, (uint32_t) (stats->ns / runs),
+             (uint32_t) (stats->rd[0] / runs), (uint32_t) (stats->wr[0] / runs),
+             (uint32_t) (stats->rd[1] / runs), (uint32_t) (stats->wr[1] / runs));
+#else
+      printf("[NPU_SOL]network=%s:eb=%lu:kind=%s:runs=%lu:ns=%lu:"
+             "cycles=%lu:active_max=%lu:active_sum=%lu:engines=%lu[NPU_EOL]\r\n",
+             npuProfileName[n], b, stats->kind, runs, (uint32_t) (stats->ns / runs),
+             (uint32_t) (stats->cycles / runs), (uint32_t) (stats->activeMax / runs),
+             (uint32_t) (stats->activeSum / runs), stats->engines / runs);
+#endif
+    }
+  }
+  memset(npuProfile, 0, sizeof(npuProfile));
+}
+#endif /* NPU_PROFILE */
@@ -0,0 +1,202 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_wfe.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "app_npu_wfe.h"
+#include "app_config.h"
+#include "pwr_timestamp.h"
+#include "system_clock.h"
+
+#if (CPU_FRQ_SCALE_DOWN_ADAPTIVE == 1)
+/* weight of the previous runs in the learned duration of an epoch block, in quarters */
+#define NPU_WFE_LEARN_WEIGHT 3
+
+/* CPU clock choices and learned duration of an epoch block. The duration is kept in NPU
+ * cycles, so it stays valid when the block runs at another NPU clock (NPU_FRQ_SCALING,
+ * NN_EPOCH_FREQ_PLAN) */
+typedef struct
+{
+  uint32_t durationCycles;  /* learned duration in NPU cycles, 0 until the block ran once */
+  uint32_t down;        /* waits with the CPU clock lowered */
+  uint32_t kept;        /* waits with the CPU clock kept, expected wait below break-even */
+  uint64_t switchNs;    /* time spent lowering and restoring the CPU clock */
+} NPU_WFE_Block_t;
+
+static NPU_WFE_Block_t npuWfe[NPU_WFE_NETWORKS][NN_EPOCH_TRACE_MAX_BLOCKS];
+static const char *npuWfeName[NPU_WFE_NETWORKS];
+
+/* epoch block running on the NPU, NULL between blocks */
+static NPU_WFE_Block_t *npuWfeCurrent;
+static uint32_t npuWfeStart;
+static uint32_t npuWfeExpectedNs;
+static uint32_t npuWfeFreq;  /* NPU clock of the running epoch block */
+
+/**
+  * @brief  Duration of an epoch block estimated by the compiler, used until it is learned
+  * @param  epoch_block epoch block
+  * @retval duration in NPU cycles, 0 if unknown
+  */
+static uint32_t estimatedCycles(const EpochBlock_ItemTypeDef *epoch_block)
+{
+#ifdef LL_ATON_EB_DBG_INFO
+  return epoch_block->estimated_tot_cycles ? epoch_block->estimated_tot_cycles
+                                           : epoch_block->estimated_npu_cycles;
+#else
+  (void) epoch_block;
+  return 0;
+#endif
+}
+
+/**
+  * @brief  Set the network name used by the report
+  * @param  network network slot
+  * @param  name network name
+  * @retval None
+  */
+void NPU_WFE_SetNetworkName(uint32_t network, const char *name)
+{
+  assert(network < NPU_WFE_NETWORKS);
+  npuWfeName[network] = name;
+}
+
+/**
+  * @brief  Start of an epoch block on the NPU, sets the wait expected by next WFE
+  * @param  network network slot
+  * @param  block epoch block index in the network
+  * @param  epoch_block epoch block
+  * @retval None
+  */
+void NPU_WFE_EpochStart(uint32_t network, uint32_t block, const EpochBlock_ItemTypeDef *epoch_block)
+{
+  uint32_t cycles;
+
+  npuWfeCurrent = &npuWfe[network][block];
+  npuWfeFreq = sysclk_GetNpuClockFreq();
+  cycles = npuWfeCurrent->durationCycles ? npuWfeCurrent->durationCycles : estimatedCycles(epoch_block);
+  npuWfeExpectedNs = npuWfeFreq ? (uint32_t) (((uint64_t) cycles * 1000000000ULL) / npuWfeFreq) : 0;
+  npuWfeStart = pwr_timestamp_get_ns();
+}
+
+/**
+  * @brief  End of an epoch block, learns its duration
+  * @param  network network slot
+  * @param  block epoch block index in the network
+  * @retval None
+  */
+void NPU_WFE_EpochEnd(uint32_t network, uint32_t block)
+{
+  NPU_WFE_Block_t *stats = &npuWfe[network][block];
+  uint32_t duration = pwr_timestamp_get_ns() - npuWfeStart;
+
+  if (stats != npuWfeCurrent)
+  {
+    return;
+  }
+  duration = (uint32_t) (((uint64_t) duration * npuWfeFreq) / 1000000000ULL);
+  if (stats->durationCycles == 0)
+  {
+    stats->durationCycles = duration;
+  }
+  else
+  {
+    stats->durationCycles = (uint32_t) (((uint64_t) stats->durationCycles * NPU_WFE_LEARN_WEIGHT + duration) /
+                                        (NPU_WFE_LEARN_WEIGHT + 1));
+  }
+  npuWfeCurrent = NULL;
+}
+
+/**
+  * @brief  Before waiting for the NPU: lower the CPU clock when the remaining time of the
+  *         running epoch block exceeds the break-even of the clock switches. Unknown
+  *         waits lower the CPU clock, as without adaptive mode
+  * @retval 1 if the CPU clock was lowered, to be given to NPU_WFE_Exit
+  */
+uint32_t NPU_WFE_Enter(void)
+{
+  NPU_WFE_Block_t *stats = npuWfeCurrent;
+  uint32_t start = pwr_timestamp_get_ns();
+
+  if ((stats != NULL) && (npuWfeExpectedNs != 0))
+  {
+    int32_t remaining = (int32_t) (npuWfeExpectedNs - (start - npuWfeStart));
+
+    if (remaining < CPU_FRQ_SCALE_DOWN_BREAK_EVEN_US * 1000)
+    {
+      stats->kept++;
+      return 0;
+    }
+  }
+
+  sysclk_SetCpuMinFreq();
+  if (stats != NULL)
+  {
+    stats->down++;
+    stats->switchNs += pwr_timestamp_get_ns() - start;
+  }
+  return 1;
+}
+
+/**
+  * @brief  After waiting for the NPU: restore the CPU clock if it was lowered
+  * @param  down value returned by NPU_WFE_Enter
+  * @retval None
+  */
+void NPU_WFE_Exit(uint32_t down)
+{
+  uint32_t start;
+
+  if (!down)
+  {
+    return;
+  }
+  start = pwr_timestamp_get_ns();
+  sysclk_SetCpuMaxFreq();
+  if (npuWfeCurrent != NULL)
+  {
+    npuWfeCurrent->switchNs += pwr_timestamp_get_ns() - start;
+  }
+}
+
+/**
+  * @brief  Send the CPU clock choices of the sequence over UART, with the NPU profile
+  *         records, then reset them. Learned durations are kept
+  * @retval None
+  */
+void NPU_WFE_Report(void)
+{
+  for (uint32_t n = 0; n < NPU_WFE_NETWORKS; n++)
+  {
+    for (uint32_t b = 0; b < NN_EPOCH_TRACE_MAX_BLOCKS; b++)
+    {
+      NPU_WFE_Block_t *stats = &npuWfe[n][b];
+
+      if ((stats->down == 0) && (stats->kept == 0))
+      {
+        continue;
+      }
+      printf("[NPU_SOL]network=%s:eb=%lu:wfe_down=%lu:wfe_kept=%lu:wfe_switch_ns=%lu:learned_cycles=%lu[NPU_EOL]\r\n",
+             npuWfeName[n], b, stats->down, stats->kept, (uint32_t) stats->switchNs, stats->durationCycles);
+      stats->down = 0;
+      stats->kept = 0;
+      stats->switchNs = 0;
+    }
+  }
+}
+#endif /* CPU_FRQ_SCALE_DOWN_ADAPTIVE */
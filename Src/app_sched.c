@@ -0,0 +1,141 @@
+ /**
+ ******************************************************************************
+ * @file    app_sched.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2024 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include <assert.h>
+#include "app_sched.h"
+#include "stm32n6xx_hal.h"
+
+static const SCHED_Stage_t *schedStages[SCHED_MAX_STAGES];
+static int schedNbStages;
+/* events handled by at least one registered stage */
+static uint32_t schedTriggers;
+/* events posted and not yet dispatched */
+static volatile uint32_t schedPending;
+/* events a stage is waiting for, used to select the sleep mode */
+static volatile uint32_t schedExpected;
+
+/**
+  * @brief  Register a stage, stages are dispatched in registration order
+  * @param  stage stage descriptor, must remain valid while the scheduler runs
+  * @retval None
+  */
+void SCHED_Register(const SCHED_Stage_t *stage)
+{
+  assert(schedNbStages < SCHED_MAX_STAGES);
+  assert(stage->run != NULL);
+
+  schedStages[schedNbStages++] = stage;
+  schedTriggers |= stage->trigger;
+}
+
+/**
+  * @brief  Post events, can be called from interrupt handlers
+  * @param  events events mask
+  * @retval None
+  */
+void SCHED_Post(uint32_t events)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  schedPending |= events;
+  schedExpected &= ~events;
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Discard pending events
+  * @param  events events mask
+  * @retval None
+  */
+void SCHED_Clear(uint32_t events)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  schedPending &= ~events;
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Declare events the application is waiting for, they are passed to
+  *         SCHED_IdleHook to select the sleep mode until one of them is posted
+  * @param  events events mask
+  * @retval None
+  */
+void SCHED_Expect(uint32_t events)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  schedExpected |= events & ~schedPending;
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Scheduler loop: run the first stage activated by the pending events,
+  *         sleep when no event is pending. Never returns.
+  * @param  None
+  * @retval None
+  */
+void SCHED_Run(void)
+{
+  while (1)
+  {
+    const SCHED_Stage_t *stage = NULL;
+    uint32_t events = 0;
+
+    __disable_irq();
+    /* events without stage are dropped */
+    schedPending &= schedTriggers;
+    for (int i = 0; i < schedNbStages; i++)
+    {
+      events = schedPending & schedStages[i]->trigger;
+      if (events)
+      {
+        stage = schedStages[i];
+        schedPending &= ~events;
+        break;
+      }
+    }
+    if (stage == NULL)
+    {
+      /* single sleep point, interrupts are masked so no event can be missed:
+         a pending interrupt still wakes-up the CPU */
+      SCHED_IdleHook(schedExpected);
+    }
+    __enable_irq();
+
+    if (stage != NULL)
+    {
+      stage->run(events);
+    }
+  }
+}
+
+/**
+  * @brief  Sleep until next interrupt, called with interrupts masked.
+  *         Can be overridden by the application to select the low power mode.
+  * @param  expected events a stage is waiting for
+  * @retval None
+  */
+__weak void SCHED_IdleHook(uint32_t expected)
+{
+  UNUSED(expected);
+  HAL_PWR_EnterSLEEPMode(0, PWR_SLEEPENTRY_WFI);
+}
@@ -0,0 +1,160 @@
+ /**
+ ******************************************************************************
+ * @file    app_timer.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2024 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include <assert.h>
+#include "app_timer.h"
+#include "app_sched.h"
+#include "stm32n6xx_hal.h"
+#include "stm32n6xx_ll_lptim.h"
+#include "stm32n6xx_ll_exti.h"
+
+/* LPTIM1 is clocked by LSI, the prescaler is selected to fit the period in the 16 bits counter */
+#define TIMER_MAX_TICKS  0x10000UL
+#define TIMER_MAX_PRESC  7
+
+static int timerRunning;
+static uint32_t timerPresc;
+static uint32_t timerTicks;
+/* number of periods elapsed since start */
+static volatile uint32_t timerPeriods;
+
+/**
+  * @brief  Start LPTIM1 periodic events, SCHED_EVT_TIMER is posted at end of each period
+  * @param  period_ms period in ms
+  * @retval None
+  */
+void TIMER_Periodic_Start(uint32_t period_ms)
+{
+  uint32_t ticks = (uint32_t) (((uint64_t) period_ms * LSI_VALUE) / 1000);
+
+  timerPresc = 0;
+  while ((ticks >> timerPresc) > TIMER_MAX_TICKS)
+  {
+    timerPresc++;
+  }
+  assert(timerPresc <= TIMER_MAX_PRESC);
+  timerTicks = ticks >> timerPresc;
+  assert(timerTicks > 1);
+
+  __HAL_RCC_LSI_ENABLE();
+  while (LL_RCC_LSI_IsReady() == 0);
+
+  __HAL_RCC_LPTIM1_CONFIG(RCC_LPTIM1CLKSOURCE_LSI);
+  __HAL_RCC_LPTIM1_CLK_ENABLE();
+  __HAL_RCC_LPTIM1_CLK_SLEEP_ENABLE();
+  __HAL_RCC_LPTIM1_FORCE_RESET();
+  __HAL_RCC_LPTIM1_RELEASE_RESET();
+
+  /* configuration register is written while the timer is disabled */
+  LL_LPTIM_SetClockSource(LPTIM1, LL_LPTIM_CLK_SOURCE_INTERNAL);
+  LL_LPTIM_SetPrescaler(LPTIM1, timerPresc << LPTIM_CFGR_PRESC_Pos);
+
+  LL_LPTIM_Enable(LPTIM1);
+  LL_LPTIM_EnableIT_ARRM(LPTIM1);
+  while (LL_LPTIM_IsActiveFlag_DIEROK(LPTIM1) == 0);
+  LL_LPTIM_ClearFlag_DIEROK(LPTIM1);
+  LL_LPTIM_SetAutoReload(LPTIM1, timerTicks - 1);
+  while (LL_LPTIM_IsActiveFlag_ARROK(LPTIM1) == 0);
+  LL_LPTIM_ClearFlag_ARROK(LPTIM1);
+
+  /* LPTIM1 EXTI line, wake-up from STOP mode */
+  LL_EXTI_EnableIT_32_63(LL_EXTI_LINE_52);
+
+  timerPeriods = 0;
+  timerRunning = 1;
+  HAL_NVIC_SetPriority(LPTIM1_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(LPTIM1_IRQn);
+  LL_LPTIM_StartCounter(LPTIM1, LL_LPTIM_OPERATING_MODE_CONTINUOUS);
+}
+
+/**
+  * @brief  Stop periodic events and switch-off LPTIM1 and LSI
+  * @param  None
+  * @retval None
+  */
+void TIMER_Periodic_Stop(void)
+{
+  HAL_NVIC_DisableIRQ(LPTIM1_IRQn);
+  LL_EXTI_DisableIT_32_63(LL_EXTI_LINE_52);
+  LL_LPTIM_Disable(LPTIM1);
+  __HAL_RCC_LPTIM1_CLK_DISABLE();
+  __HAL_RCC_LPTIM1_CLK_SLEEP_DISABLE();
+  __HAL_RCC_LSI_DISABLE();
+  SCHED_Clear(SCHED_EVT_TIMER);
+  timerRunning = 0;
+}
+
+/**
+  * @brief  Get periodic events state
+  * @param  None
+  * @retval 1 if periodic events are running
+  */
+int TIMER_Periodic_IsRunning(void)
+{
+  return timerRunning;
+}
+
+/**
+  * @brief  Get time elapsed in the current period
+  * @param  period_idx returns the index of the current period, can be NULL
+  * @retval time elapsed since start of current period in us (resolution of one LPTIM tick)
+  */
+uint32_t TIMER_Periodic_GetTime(uint32_t *period_idx)
+{
+  uint32_t primask = __get_PRIMASK();
+  uint32_t cnt, cnt2;
+  uint32_t periods;
+
+  __disable_irq();
+  /* counter is clocked asynchronously, read until two consecutive values match */
+  cnt = LL_LPTIM_GetCounter(LPTIM1);
+  do
+  {
+    cnt2 = cnt;
+    cnt = LL_LPTIM_GetCounter(LPTIM1);
+  } while (cnt != cnt2);
+  periods = timerPeriods;
+  if (LL_LPTIM_IsActiveFlag_ARRM(LPTIM1) && (cnt < timerTicks / 2))
+  {
+    /* period elapsed, interrupt not yet served */
+    periods++;
+  }
+  __set_PRIMASK(primask);
+
+  if (period_idx)
+  {
+    *period_idx = periods;
+  }
+
+  return (uint32_t) (((uint64_t) cnt * (1000000UL << timerPresc)) / LSI_VALUE);
+}
+
+/**
+  * @brief  LPTIM1 interrupt: end of period
+  * @param  None
+  * @retval None
+  */
+void TIMER_Periodic_IRQHandler(void)
+{
+  if (LL_LPTIM_IsActiveFlag_ARRM(LPTIM1))
+  {
+    LL_LPTIM_ClearFlag_ARRM(LPTIM1);
+    timerPeriods++;
+    SCHED_Post(SCHED_EVT_TIMER);
+  }
+}
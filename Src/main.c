@@ -17,6 +17,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "cmw_camera.h"
 #include "stm32n6570_discovery_bus.h"
@@ -29,6 +30,14 @@
 #include "app_postprocess.h"
 #include "ll_aton_runtime.h"
 #include "app_cam.h"
+#include "app_nn.h"
+#include "app_sched.h"
+#include "app_timer.h"
+#include "app_motion.h"
+#include "app_npu_profile.h"
+#include "app_npu_freq_plan.h"
+#include "app_npu_wfe.h"
+#include "app_dvfs.h"
 #include "main.h"
 #include "stm32n6xx_hal_rif.h"
 #include "app_config.h"
@@ -43,6 +52,7 @@ const FrequencyStep frequencySteps[] =
   	.pll2Cfg = {.PLLState = RCC_PLL_ON, .PLLSource = RCC_PLLSOURCE_HSE, .PLLN = 125, .PLLM = 6, .PLLP1 = 1, .PLLP2 = 1, .PLLFractional = 0},
   	.pll3Cfg = {.PLLState = RCC_PLL_ON, .PLLSource = RCC_PLLSOURCE_HSE, .PLLN = 75, .PLLM = 4, .PLLP1 = 1, .PLLP2 = 1, .PLLFractional = 0},
   	.npufreq = 1000,
+  	.overdrive = 1,
   	.cpuClkSrc = RCC_ICCLKSOURCE_PLL1,
   	.npuClkSrc = RCC_ICCLKSOURCE_PLL2,
   	.npuRamsClkSrc = RCC_ICCLKSOURCE_PLL3,
@@ -99,7 +109,7 @@ CLASSES_TABLE;
 
 #define MAX_NUMBER_OUTPUT 5
 
-#if POSTPROCESS_TYPE == POSTPROCESS_OD_YOLO_V2_UF
+#if (POSTPROCESS_TYPE == POSTPROCESS_OD_YOLO_V2_UF) || (POSTPROCESS_TYPE == POSTPROCESS_OD_YOLO_V2_UI)
  yolov2_pp_static_param_t pp_params;
 #elif POSTPROCESS_TYPE == POSTPROCESS_OD_YOLO_V5_UU
  yolov5_pp_static_param_t pp_params;
@@ -119,11 +129,25 @@ yolov8_pp_static_param_t pp_params;
 __attribute__ ((aligned (32)))
 uint8_t nn_in_buffer[NN_WIDTH*NN_HEIGHT*NN_BPP];
 
+#if (STREAMING_MODE == 1)
+/* second capture buffer, the NN pipe alternates between both in streaming mode */
+__attribute__ ((aligned (32)))
+uint8_t nn_in_buffer_1[NN_WIDTH*NN_HEIGHT*NN_BPP];
+#endif /* STREAMING_MODE */
+
 volatile int32_t cameraFrameReceived;
+volatile uint32_t cameraFrameTimestamp;
+#if (CAMERA_WARM_MODE == 1)
+static int cameraWarm;
+#endif
 
 const LL_Buffer_InfoTypeDef *nn_in_info;
 const LL_Buffer_InfoTypeDef *nn_out_info;
 LL_ATON_DECLARE_NAMED_NN_INSTANCE_AND_INTERFACE(Default);
+#if (CASCADE_MODE == 1)
+/* second network of the cascade, generated with "--name cascade" */
+LL_ATON_DECLARE_NAMED_NN_INSTANCE_AND_INTERFACE(cascade);
+#endif
 int number_output = 0;
 
 od_pp_out_t pp_output;
@@ -133,6 +157,87 @@ UART_HandleTypeDef huart1;
 float32_t *nn_out[MAX_NUMBER_OUTPUT];
 int32_t nn_out_len[MAX_NUMBER_OUTPUT];
 
+#if (PERIODIC_CAPTURE == 1)
+/* periodic capture statistics, latencies are measured from the start of the trigger period */
+static uint32_t periodicFrames;
+static uint32_t periodicIdx;        /* period index of current frame */
+static uint32_t periodicWakeup;     /* latency to the start of the capture stage */
+static uint32_t periodicLatency;    /* latency to the end of post-processing */
+static uint32_t periodicLatencyMin;
+static uint32_t periodicLatencyMax;
+static uint32_t periodicOverruns;   /* frames longer than the period, next trigger is skipped */
+#endif
+
+#if (IDLE_STOP_MODE == 1)
+/* AXISRAM1/2 (secure alias) keep their content in STOP mode */
+#define STOP_RETAINED_RAM_START 0x34000000UL
+#define STOP_RETAINED_RAM_END   0x34200000UL
+#define IS_STOP_RETAINED(addr)  ((((uint32_t) (addr)) >= STOP_RETAINED_RAM_START) && \
+                                 (((uint32_t) (addr)) < STOP_RETAINED_RAM_END))
+#endif
+
+/* external memories state, they are configured during capture when EXTMEM_EARLY_INIT is enabled */
+static int extMemConfigured;
+#if (EXTMEM_EARLY_INIT == 1) && (STREAMING_MODE == 0)
+static uint32_t extMemInitTime;
+static uint32_t extMemHiddenTime;
+#endif
+
+#if (NPU_FRQ_SCALING == 0)
+/* number of triggers processed since reset, used by the warm-up policy */
+static uint32_t nnTriggerCount;
+#endif
+
+#if (CASCADE_MODE == 1)
+/* cascade statistics */
+static uint32_t cascadeRuns;      /* frames where the detector fired and the classifier ran */
+static uint32_t cascadeSkips;     /* frames where the classifier was skipped */
+static int32_t cascadeClass = -1; /* class of the last classifier run */
+#endif
+
+#if (SMPS_OVERDRIVE_BATCH > 1)
+static uint32_t smpsTriggerCount;  /* triggers since reset, counts the overdrive windows */
+#endif
+#if (SMPS_LATENCY_BUDGET_US > 0)
+/* SMPS latency budget statistics */
+static uint32_t smpsNominalUs;     /* inference latency at the nominal fallback, 0 until measured */
+static uint32_t smpsNominalRuns;   /* overdrive inferences replaced by the nominal fallback */
+static uint32_t smpsOverdriveRuns;
+#endif
+
+#if (MOTION_GATE == 1)
+/* motion gate statistics */
+static uint32_t motionScore;       /* changed cells of the last frame */
+static uint32_t motionSkipped;     /* consecutive frames without inference */
+static uint32_t motionSkippedTotal;
+static uint32_t motionInferred;
+#endif
+
+#if (PWR_TIMESTAMP_BACKGROUND_DRAIN == 1)
+#if (PWR_TIMESTAMP_BINARY == 1)
+#define TIMESTAMP_DRAIN_CHUNK 16 /* entries per binary frame */
+#else
+#define TIMESTAMP_DRAIN_CHUNK 1  /* one ASCII line per idle period between triggers */
+#endif
+#endif
+
+#if (ROI_SECOND_PASS == 1)
+static int roiPass;                /* 0: full frame pass, 1: ROI pass */
+static od_pp_outBuffer_t roiBox;   /* top detection of the full frame pass */
+static int32_t roiFirstDetect;     /* detections of the full frame pass */
+#endif
+
+#if (STREAMING_MODE == 1)
+#define PP_IN_BUFFER_SIZE  (8 * 1024)
+/* copy of frame N-1 outputs, post-processed while the NPU runs frame N */
+__attribute__ ((aligned (32)))
+static uint8_t pp_in_buffer[PP_IN_BUFFER_SIZE];
+float32_t *pp_in[MAX_NUMBER_OUTPUT];
+static int streamingProcessed;
+static int streamingPpPending;        /* pp_in holds outputs not post-processed yet */
+static uint32_t streamingPpSerial;    /* post-processings not overlapped with the next inference */
+#endif /* STREAMING_MODE */
+
 static void NPURam_enable(void);
 static void NPURam_disable(void);
 static void NPUCache_enable(void);
@@ -141,15 +246,68 @@ static void Security_Config(void);
 static void IAC_Config(void);
 static void GPIO_Config(void);
 static void Console_Config(void);
-static void waitForUserTrigger(void);
+static void userTriggerArm(void);
 static void cameraInit(void);
 static void startStlinkPwr(void);
+#if (STREAMING_MODE == 0)
 static void cameraCapture(void);
+#endif
+static void cameraSleepClocksEnable(void);
+void externMem_config(void);
 static void cameraDeInit(void);
-static void nn_inference(void);
+static void npuConfig(void);
+static void npuSetInputBuffer(uint8_t *buffer);
+static void npuDeConfig(void);
+#if (NPU_FRQ_SCALING == 0)
+static int nn_warmup(void);
+#endif
+#if (STREAMING_MODE == 1)
+static void streamingPipeline(void);
+#endif
+#if (CASCADE_MODE == 0)
 static void postProcessing(void);
+static void postProcessingRun(void);
+#endif
+static void postProcessingEnd(void);
+static void postProcessingRelease(void);
+#if (ROI_SECOND_PASS == 1)
+static void roiStage(uint32_t events);
+#endif
+#if (CASCADE_MODE == 1)
+static void cascadeRun(NN_Instance_TypeDef *instance, int freqStep, const char *name);
+static void cascadeEnd(void);
+static void cascadeStage(uint32_t events);
+#endif
 static void sendTimestamp(void);
 static void deInitIPs(void);
+static void captureStage(uint32_t events);
+#if (STREAMING_MODE == 0)
+static void preprocessStage(uint32_t events);
+#if (MOTION_GATE == 1)
+static int motionGate(void);
+#endif
+static void inferStage(uint32_t events);
+static void postprocessStage(uint32_t events);
+#endif
+static void reportStage(uint32_t events);
+
+/* application stages, dispatched by the scheduler in this order when several are ready */
+static const SCHED_Stage_t appStages[] =
+{
+  { .name = "capture",     .trigger = SCHED_EVT_TRIGGER | SCHED_EVT_TIMER,   .run = captureStage },
+#if (STREAMING_MODE == 0)
+  { .name = "preprocess",  .trigger = SCHED_EVT_FRAME,                       .run = preprocessStage },
+  { .name = "infer",       .trigger = SCHED_EVT_FRAME_READY | SCHED_EVT_NPU, .run = inferStage },
+  { .name = "postprocess", .trigger = SCHED_EVT_NN_DONE,                     .run = postprocessStage },
+#endif
+#if (CASCADE_MODE == 1)
+  { .name = "cascade",     .trigger = SCHED_EVT_CASCADE,                     .run = cascadeStage },
+#endif
+#if (ROI_SECOND_PASS == 1)
+  { .name = "roi",         .trigger = SCHED_EVT_ROI,                         .run = roiStage },
+#endif
+  { .name = "report",      .trigger = SCHED_EVT_PP_DONE,                     .run = reportStage },
+};
 
 /**
   * @brief  Main program
@@ -214,65 +372,221 @@ int main(void)
     nn_out_len[i] = LL_Buffer_len(&nn_out_info[i]);
   }
 
+#if (STREAMING_MODE == 1)
+  uint32_t pp_in_offset = 0;
+  for (int i = 0; i < number_output; i++)
+  {
+    pp_in[i] = (float32_t *) &pp_in_buffer[pp_in_offset];
+    pp_in_offset += (nn_out_len[i] + 31) & ~31;
+  }
+  assert(pp_in_offset <= PP_IN_BUFFER_SIZE);
+#endif /* STREAMING_MODE */
+
   app_postprocess_init(&pp_params);
+#if POSTPROCESS_TYPE == POSTPROCESS_OD_YOLO_V2_UI
+  /* dequantization done by the post-processing: network generated without the final Dequantize layer */
+  assert((nn_out_info[0].type == DataType_INT8) && (nn_out_info[0].scale != NULL));
+  assert(nn_out_info[0].scale[0] == AI_OD_YOLOV2_PP_SCALE);
+  assert(nn_out_info[0].offset[0] == AI_OD_YOLOV2_PP_ZERO_POINT);
+#endif
+
+#if (NPU_FRQ_SCALING == 1)
+  for (int i = 0; i < sizeof(frequencySteps) / sizeof(frequencySteps[0]); i++)
+  {
+    sysclk_NpuFreqScalingPrepare(&frequencySteps[i]);
+  }
+#endif
+#if (DVFS_CALIBRATION == 1) || (DVFS_OPERATING_POINT >= 0)
+  DVFS_Init(frequencySteps, sizeof(frequencySteps) / sizeof(frequencySteps[0]));
+  assert(DVFS_OPERATING_POINT < (int) DVFS_GetNbOperatingPoints());
+#endif
+
+#if (IDLE_STOP_MODE == 1)
+  /* capture buffer and post-processing context are kept across STOP mode */
+  assert(IS_STOP_RETAINED(nn_in_buffer));
+  assert(IS_STOP_RETAINED(&pp_params));
+  assert(IS_STOP_RETAINED(&pp_output));
+#endif
 
   /*** App Loop ***************************************************************/
-  while (1)
+  for (int i = 0; i < sizeof(appStages) / sizeof(appStages[0]); i++)
   {
-    /* Wait for USER1 trigger */
-    waitForUserTrigger();
-    
-    /* Start STLINKPWR */
-    startStlinkPwr();
-
-    /* Camera initialization */
-    cameraInit();
-
-    /* Camera capture */
-    cameraCapture();
-    
-    /* Camera de-initialization */
-    cameraDeInit();
-    
-    /* Inference */
-    nn_inference();
-    
-    /* Post-processing */
-    postProcessing();
-    
-    /* Send timestamps */
-    sendTimestamp();
-    
-    /* De-initialize IPs */
-    deInitIPs();
+    SCHED_Register(&appStages[i]);
   }
+
+  /* Wait for USER1 trigger */
+  userTriggerArm();
+
+  /* capture -> preprocess -> infer -> postprocess -> report, driven by IRQ events */
+  SCHED_Run();
 }
 
 /**
-  * @brief  Wait USER1 push button
+  * @brief  Get ready for next USER1 push button, the scheduler sleeps until it is pressed
   * @param  None
   * @retval None
   */
-static void waitForUserTrigger(void)
+static void userTriggerArm(void)
 {
   /* reset TGI pin and clear any pending interrupt before going into sleep mode */
   HAL_GPIO_WritePin(STLINKPWR_TGI_PORT, STLINKPWR_TGI_PIN, GPIO_PIN_RESET);
   HAL_NVIC_ClearPendingIRQ(EXTI13_IRQn);
   HAL_NVIC_DisableIRQ(CSI_IRQn);
-  /* enter in sleep mode and wait wake-up by USER1 button interrupt */
+  /* ignore USER1 pushes and timer periods elapsed during the previous measurement */
+  SCHED_Clear(SCHED_EVT_TRIGGER | SCHED_EVT_TIMER);
+  SCHED_Expect(SCHED_EVT_TRIGGER | SCHED_EVT_TIMER);
+}
+
+/**
+  * @brief  USER1 push button interrupt
+  * @param  GPIO_Pin pin of the EXTI line
+  * @retval None
+  */
+void HAL_GPIO_EXTI_Rising_Callback(uint16_t GPIO_Pin)
+{
+  if (GPIO_Pin == GPIO_PIN_13)
+  {
+    SCHED_Post(SCHED_EVT_TRIGGER);
+  }
+}
+
+/**
+  * @brief  Scheduler sleep point, called with interrupts masked when no event is pending.
+  *         The CPU clock is lowered while the NPU runs an epoch (as LL_ATON_OSAL_WFE),
+  *         systick is suspended to only wake-up on application events.
+  *         With IDLE_STOP_MODE, STOP mode is used between triggers.
+  *         With PWR_TIMESTAMP_BACKGROUND_DRAIN, timestamps are only sent between triggers,
+  *         so no measured step includes the UART time.
+  * @param  expected events the stages are waiting for
+  * @retval None
+  */
+void SCHED_IdleHook(uint32_t expected)
+{
+#if (PWR_TIMESTAMP_BACKGROUND_DRAIN == 1) || (IDLE_STOP_MODE == 1)
+  /* only USER1 or the periodic timer can start the next step */
+  uint32_t betweenTriggers = (expected != 0) && ((expected & ~(SCHED_EVT_TRIGGER | SCHED_EVT_TIMER)) == 0);
+#endif
+
+#if (PWR_TIMESTAMP_BACKGROUND_DRAIN == 1)
+  if (betweenTriggers && pwr_timestamp_pending())
+  {
+#if (PWR_TIMESTAMP_BINARY == 1)
+    /* start one frame over UART DMA and sleep, the transfer complete interrupt
+       wakes-up the CPU to start the next one */
+    pwr_timestamp_drain_async(TIMESTAMP_DRAIN_CHUNK);
+#else
+    /* send one line instead of sleeping, the scheduler checks the events again on return */
+    __enable_irq();
+    pwr_timestamp_drain(TIMESTAMP_DRAIN_CHUNK);
+    __disable_irq();
+    return;
+#endif
+  }
+  /* USART1 and GPDMA1 are stopped in STOP mode */
+  betweenTriggers = betweenTriggers && !pwr_timestamp_drain_busy();
+#endif
+#if (IDLE_STOP_MODE == 1)
+  if (betweenTriggers)
+  {
+    /* between triggers: only USER1 (EXTI13) or LPTIM1 (EXTI52) can wake-up the CPU */
+    HAL_SuspendTick();
+    HAL_PWR_EnterSTOPMode(PWR_MAINREGULATOR_ON, PWR_STOPENTRY_WFI);
+    /* system is back on HSI: restore clocks before the wake-up interrupt is served */
+    sysclk_SystemClockRestore();
+    HAL_ResumeTick();
+    return;
+  }
+#endif
+#if (CPU_FRQ_SCALE_DOWN_ADAPTIVE == 1)
+  uint32_t down = (expected & SCHED_EVT_NPU) ? NPU_WFE_Enter() : 0;
+#else
+  if (expected & SCHED_EVT_NPU)
+  {
+    sysclk_SetCpuMinFreq();
+  }
+#endif
   HAL_SuspendTick();
   HAL_PWR_EnterSLEEPMode(0, PWR_SLEEPENTRY_WFI);
   HAL_ResumeTick();
+#if (CPU_FRQ_SCALE_DOWN_ADAPTIVE == 1)
+  NPU_WFE_Exit(down);
+#else
+  if (expected & SCHED_EVT_NPU)
+  {
+    sysclk_SetCpuMaxFreq();
+  }
+#endif
+}
+
+/**
+  * @brief  capture stage, started by USER1 push button
+  * @param  events activating events
+  * @retval None
+  */
+static void captureStage(uint32_t events)
+{
+#if (PERIODIC_CAPTURE == 1)
+  if (events & SCHED_EVT_TRIGGER)
+  {
+    if (TIMER_Periodic_IsRunning())
+    {
+      /* USER1 stops the periodic triggers */
+      TIMER_Periodic_Stop();
+      userTriggerArm();
+      return;
+    }
+    /* USER1 starts the periodic triggers, first frame is captured now */
+    TIMER_Periodic_Start(PERIODIC_CAPTURE_PERIOD_MS);
+    periodicFrames = 0;
+    periodicOverruns = 0;
+    periodicLatencyMin = UINT32_MAX;
+    periodicLatencyMax = 0;
+  }
+  periodicWakeup = TIMER_Periodic_GetTime(&periodicIdx);
+#else
+  UNUSED(events);
+#endif
   pwr_timestamp_init();
+
+  /* Start STLINKPWR */
+  startStlinkPwr();
+
+#if (PWR_TIMESTAMP_BACKGROUND_DRAIN == 1)
+  /* timestamps are drained while waiting for events */
+  Console_Config();
+#endif
+
+  /* Camera initialization */
+  cameraInit();
+
+#if (STREAMING_MODE == 1)
+  /* Continuous capture, inference and post-processing, run as a single stage */
+  streamingPipeline();
+  SCHED_Post(SCHED_EVT_PP_DONE);
+#else
+  /* Camera capture, preprocess stage runs on frame reception */
+  cameraCapture();
+#endif /* STREAMING_MODE */
 }
 
 /**
-  * @brief  init camera sensor and camera pipline (Csi and Dcmipp)
+  * @brief  init camera sensor and camera pipline (Csi and Dcmipp),
+  *         or wake-up the sensor from standby when CAMERA_WARM_MODE is enabled
   * @param  None
   * @retval None
   */
 static void cameraInit(void)
 {
+#if (CAMERA_WARM_MODE == 1)
+  if (cameraWarm)
+  {
+    /* sensor left in standby by previous iteration */
+    CAM_Sensor_Start();
+    pwr_timestamp_log("CAM warm resume");
+    return;
+  }
+  cameraWarm = 1;
+#endif
   CAM_Init();
   pwr_timestamp_log("CAM init");
 }
@@ -287,11 +601,15 @@ static void startStlinkPwr(void)
   /* trigger power capture */
   HAL_GPIO_WritePin(STLINKPWR_TGI_PORT, STLINKPWR_TGI_PIN, GPIO_PIN_SET);
   pwr_timestamp_start();
+#if (CLOCK_MANAGER == 1)
+  sysclk_ClockStart();
+#endif /* CLOCK_MANAGER */
   pwr_timestamp_log("start timestamp");
 }
 
+#if (STREAMING_MODE == 0)
 /**
-  * @brief  trigger camera capture and wait frame reception
+  * @brief  trigger camera capture, frame reception is signaled by SCHED_EVT_FRAME
   * @param  None
   * @retval None
   */
@@ -299,43 +617,148 @@ static void cameraCapture(void)
 {
   cameraFrameReceived = 0;
 
-  /* enable low power clocks */
-  __HAL_RCC_DCMIPP_CLK_SLEEP_ENABLE();
-  __HAL_RCC_CSI_CLK_SLEEP_ENABLE();
-  __HAL_RCC_AXISRAM1_MEM_CLK_SLEEP_ENABLE();
-  __HAL_RCC_AXISRAM2_MEM_CLK_SLEEP_ENABLE();
-  __HAL_RCC_FLEXRAM_MEM_CLK_SLEEP_ENABLE();
-  __HAL_RCC_TIM2_CLK_SLEEP_ENABLE();
-  __HAL_RCC_I2C1_CLK_SLEEP_ENABLE();
-  __HAL_RCC_I2C2_CLK_SLEEP_ENABLE();
+  cameraSleepClocksEnable();
   
   /* Start NN camera single capture Snapshot */
   CAM_NNPipe_Start(nn_in_buffer, CMW_MODE_SNAPSHOT);
   pwr_timestamp_log("camera started");
 
-  HAL_SuspendTick();
-  while (cameraFrameReceived == 0)
+#if (EXTMEM_EARLY_INIT == 1)
+  /* bring-up external memories while the frame is captured instead of sleeping */
+  uint32_t extMemStart = pwr_timestamp_get();
+  externMem_config();
+  uint32_t extMemEnd = pwr_timestamp_get();
+  extMemInitTime = extMemEnd - extMemStart;
+  if (cameraFrameReceived == 0)
   {
-	/* sleep during capture */
-    HAL_PWR_EnterSLEEPMode(0, PWR_SLEEPENTRY_WFI);
+    extMemHiddenTime = extMemInitTime;
   }
-  HAL_ResumeTick();
-  
+  else
+  {
+    /* frame received during init, the remaining part of the init delayed the inference */
+    extMemHiddenTime = (cameraFrameTimestamp > extMemStart) ? (cameraFrameTimestamp - extMemStart) : 0;
+  }
+#endif /* EXTMEM_EARLY_INIT */
+
+  /* sleep during capture */
+  SCHED_Expect(SCHED_EVT_FRAME);
+}
+
+/**
+  * @brief  preprocess stage, started on frame reception: ISP update and camera de-init
+  * @param  events activating events
+  * @retval None
+  */
+static void preprocessStage(uint32_t events)
+{
+  UNUSED(events);
   pwr_timestamp_log("wait frame");
 
   CAM_IspUpdate();
   pwr_timestamp_log("ISP update");
+
+#if (ROI_SECOND_PASS == 1)
+  if (roiPass == 1)
+  {
+    /* back to full frame for next trigger */
+    CAM_NNPipe_ResetRoi();
+  }
+#endif
+
+  /* Camera de-initialization */
+  cameraDeInit();
+
+#if (MOTION_GATE == 1)
+#if (ROI_SECOND_PASS == 1)
+  if ((roiPass == 0) && !motionGate())
+#else
+  if (!motionGate())
+#endif
+  {
+    /* static scene: no inference, release external memories if configured during capture */
+    if (extMemConfigured)
+    {
+      npuDeConfig();
+    }
+    pwr_timestamp_stop();
+    SCHED_Post(SCHED_EVT_PP_DONE);
+    return;
+  }
+#endif /* MOTION_GATE */
+
+  SCHED_Post(SCHED_EVT_FRAME_READY);
 }
 
+#if (MOTION_GATE == 1)
 /**
-  * @brief  Deinit camera sensor and camera pipeline (Csi and Dcmipp)
+  * @brief  compare a thumbnail of the captured frame with the last inferred one
+  * @param  None
+  * @retval 1 if the inference must run, 0 if it is skipped
+  */
+static int motionGate(void)
+{
+  int run;
+
+  /* frame written by DCMIPP, drop stale lines before the cpu reads it */
+  SCB_InvalidateDCache_by_Addr(nn_in_buffer, sizeof(nn_in_buffer));
+  motionScore = MOTION_Score(nn_in_buffer, NN_WIDTH, NN_HEIGHT, NN_BPP);
+
+  run = (motionScore >= MOTION_GATE_MIN_CELLS);
+#if (MOTION_GATE_MAX_SKIP > 0)
+  run |= (motionSkipped >= MOTION_GATE_MAX_SKIP);
+#endif
+
+  if (run)
+  {
+    MOTION_SetReference();
+    motionSkipped = 0;
+    motionInferred++;
+    pwr_timestamp_log("motion gate: inference");
+  }
+  else
+  {
+    motionSkipped++;
+    motionSkippedTotal++;
+    pwr_timestamp_log("motion gate: skip");
+  }
+
+  return run;
+}
+#endif /* MOTION_GATE */
+#endif /* STREAMING_MODE */
+
+/**
+  * @brief  keep the clocks needed by the capture enabled in sleep mode
+  * @param  None
+  * @retval None
+  */
+static void cameraSleepClocksEnable(void)
+{
+  __HAL_RCC_DCMIPP_CLK_SLEEP_ENABLE();
+  __HAL_RCC_CSI_CLK_SLEEP_ENABLE();
+  __HAL_RCC_AXISRAM1_MEM_CLK_SLEEP_ENABLE();
+  __HAL_RCC_AXISRAM2_MEM_CLK_SLEEP_ENABLE();
+  __HAL_RCC_FLEXRAM_MEM_CLK_SLEEP_ENABLE();
+  __HAL_RCC_TIM2_CLK_SLEEP_ENABLE();
+  __HAL_RCC_I2C1_CLK_SLEEP_ENABLE();
+  __HAL_RCC_I2C2_CLK_SLEEP_ENABLE();
+}
+
+/**
+  * @brief  Deinit camera sensor and camera pipeline (Csi and Dcmipp),
+  *         sensor is only put in standby when CAMERA_WARM_MODE is enabled
   * @param  None
   * @retval None
   */
 static void cameraDeInit(void)
 {
+#if (CAMERA_WARM_MODE == 1)
+  CAM_Sensor_Stop();
+  pwr_timestamp_log("camera standby");
+#else
   CAM_DeInit();
   pwr_timestamp_log("camera de-init");
+#endif
 }
 
 
@@ -363,10 +786,96 @@ void externMem_config(void)
   BSP_XSPI_NOR_EnableMemoryMappedMode(0);
   __HAL_RCC_XSPI2_CLK_SLEEP_ENABLE();
   pwr_timestamp_log("NOR flash init");
+  extMemConfigured = 1;
 }
 
 
-#if(NPU_FRQ_SCALING == 1)
+#if (NPU_FRQ_SCALING == 1) && (CASCADE_MODE == 0)
+#if (DVFS_CALIBRATION == 1) || (DVFS_OPERATING_POINT >= 0)
+/**
+  * @brief  configure clocks of an operating point and run inferences
+  * @param  point operating point
+  * @param  runs number of inferences, each one logged with the operating point name
+  * @retval latency of the last inference in us
+  */
+static uint32_t runInference_operatingPoint(const FrequencyStep *point, int runs)
+{
+  uint32_t start;
+  uint32_t latency = 0;
+
+  sysclk_NpuFreqScaling(point);
+  pwr_timestamp_log("config npu clock scaling");
+
+  for (int i = 0; i < runs; i++)
+  {
+    /* invalidate all caches, every inference starts from the same state */
+    npu_cache_invalidate();
+    SCB_CleanInvalidateDCache();
+    SCB_InvalidateICache();
+
+    start = pwr_timestamp_get();
+    HAL_SuspendTick();
+    NN_Run(&NN_Instance_Default);
+    HAL_ResumeTick();
+    latency = pwr_timestamp_get() - start;
+    pwr_timestamp_log(point->stepName);
+  }
+
+  return latency;
+}
+
+/**
+  * @brief  go back to the last frequency step, post processing expects nominal
+  *         voltage and CPU on PLL3 at 600MHz
+  * @param  point operating point used by the last inference
+  * @retval None
+  */
+static void runInference_restoreClocks(const FrequencyStep *point)
+{
+  if (point->overdrive || (point->cpuClkSrc != RCC_ICCLKSOURCE_PLL3))
+  {
+    sysclk_NpuFreqScaling(&frequencySteps[sizeof(frequencySteps) / sizeof(frequencySteps[0]) - 1]);
+    pwr_timestamp_log("config npu clock scaling");
+  }
+}
+
+#if (SMPS_LATENCY_BUDGET_US > 0)
+/**
+  * @brief  operating point of the inference: an overdrive point is replaced by the nominal
+  *         point with the fastest NPU clock when it meets SMPS_LATENCY_BUDGET_US, saving
+  *         the two SMPS transitions. The nominal latency is measured by the first inference
+  * @param  point selected operating point
+  * @retval operating point to run
+  */
+static const FrequencyStep *runInference_budgetPoint(const FrequencyStep *point)
+{
+  const FrequencyStep *nominal = NULL;
+
+  if (!point->overdrive)
+  {
+    return point;
+  }
+  for (int i = 0; i < DVFS_GetNbOperatingPoints(); i++)
+  {
+    const FrequencyStep *p = DVFS_GetOperatingPoint(i);
+
+    if (!p->overdrive && ((nominal == NULL) || (p->npufreq > nominal->npufreq)))
+    {
+      nominal = p;
+    }
+  }
+  if ((nominal == NULL) || (smpsNominalUs > SMPS_LATENCY_BUDGET_US))
+  {
+    smpsOverdriveRuns++;
+    return point;
+  }
+  smpsNominalRuns++;
+
+  return nominal;
+}
+#endif /* SMPS_LATENCY_BUDGET_US */
+#endif /* DVFS_CALIBRATION || DVFS_OPERATING_POINT */
+
 /**
   * @brief  configure clocks and run inferences for NPU frequency scaling mode
   * @param  None
@@ -374,6 +883,43 @@ void externMem_config(void)
   */
 static void runInference_freqScaling(void)
 {
+#if (DVFS_CALIBRATION == 1)
+  /* calibration sweep, the host computes the energy of each operating point */
+  for (int i = 0; i < DVFS_GetNbOperatingPoints(); i++)
+  {
+    runInference_operatingPoint(DVFS_GetOperatingPoint(i), DVFS_CALIBRATION_RUNS);
+  }
+  runInference_restoreClocks(DVFS_GetOperatingPoint(DVFS_GetNbOperatingPoints() - 1));
+#elif (DVFS_OPERATING_POINT >= 0)
+  /* operating point selected from a calibration */
+  const FrequencyStep *point = DVFS_GetOperatingPoint(DVFS_OPERATING_POINT);
+  uint32_t latency;
+
+#if (SMPS_LATENCY_BUDGET_US > 0)
+  point = runInference_budgetPoint(point);
+#endif
+#if (SMPS_OVERDRIVE_BATCH > 1)
+  /* overdrive kept between the inferences of a batch */
+  sysclk_SmpsHoldOverdrive(1);
+#endif
+  latency = runInference_operatingPoint(point, 1);
+  runInference_restoreClocks(point);
+#if (SMPS_OVERDRIVE_BATCH > 1)
+  /* the last inference of the batch goes back to nominal once its clocks are restored */
+  if ((++smpsTriggerCount % SMPS_OVERDRIVE_BATCH) == 0)
+  {
+    sysclk_SmpsHoldOverdrive(0);
+  }
+#endif
+#if (SMPS_LATENCY_BUDGET_US > 0)
+  if (!point->overdrive)
+  {
+    smpsNominalUs = latency;
+  }
+#else
+  UNUSED(latency);
+#endif
+#else
   for (int i = 0; i < sizeof(frequencySteps) / sizeof(frequencySteps[0]); i++)
   {
     sysclk_NpuFreqScaling(&frequencySteps[i]);
@@ -385,22 +931,25 @@ static void runInference_freqScaling(void)
     pwr_timestamp_log("config npu clock scaling");
 
     HAL_SuspendTick();
-    LL_ATON_RT_Main(&NN_Instance_Default);
+    NN_Run(&NN_Instance_Default);
     HAL_ResumeTick();
     pwr_timestamp_log(frequencySteps[i].stepName);
   }
+#endif /* DVFS_CALIBRATION */
 }
 #endif /* NPU_FRQ_SCALING */
 
 /**
-  * @brief  configures NPU and NPU memories and run inference
+  * @brief  configures NPU clocks, NPU memories and external memories
   * @param  None
   * @retval None
   */
-static void nn_inference(void)
+static void npuConfig(void)
 {
-  int ret;
-
+#if (CLOCK_MANAGER == 1)
+  /* PLL2 and PLL3 lock while the NPU memories and the external memories are configured */
+  sysclk_ClockPreLock(SYSCLK_CLOCK_NPU | SYSCLK_CLOCK_NPU_RAMS);
+#endif
   sysclk_NpuClockConfig();
   sysclk_NpuClockEnable();
   sysclk_CpuClockConfig();
@@ -414,50 +963,518 @@ static void nn_inference(void)
 
   /* config External flash in memory mapped mode,
    * config External PSRAM only if needed
+   * (skipped if already done during capture)
    */
-  externMem_config();
+  if (!extMemConfigured)
+  {
+    externMem_config();
+  }
+#if (CLOCK_MANAGER == 1)
+  /* released by the post-processing */
+  sysclk_ClockRequire(SYSCLK_CLOCK_NPU | SYSCLK_CLOCK_NPU_RAMS);
+#endif
+}
+
+/**
+  * @brief  use a capture buffer as nn_input buffer
+  * @param  buffer capture buffer
+  * @retval None
+  */
+static void npuSetInputBuffer(uint8_t *buffer)
+{
+  int ret;
 
-  /* use capture buffer as nn_input buffer */
   nn_in_info = LL_ATON_Input_Buffers_Info_Default();
   uint32_t nn_in_len = LL_Buffer_len(&nn_in_info[0]);
   /* Note that we don't need to clean/invalidate those input buffers since they are only access in hardware */
-  ret = LL_ATON_Set_User_Input_Buffer_Default(0, nn_in_buffer, nn_in_len);
+  ret = LL_ATON_Set_User_Input_Buffer_Default(0, buffer, nn_in_len);
   assert(ret == LL_ATON_User_IO_NOERROR);
-  pwr_timestamp_log("NPU and NPU Rams config");
-
-#if(NPU_FRQ_SCALING == 0)
-  /* run NN inference (dry run)*/
-  HAL_SuspendTick();
-  LL_ATON_RT_Main(&NN_Instance_Default);
-  HAL_ResumeTick();
-  pwr_timestamp_log("nn inference (dry run)");
+}
 
-  /* run NN inference */
-  HAL_SuspendTick();
-  LL_ATON_RT_Main(&NN_Instance_Default);
-  HAL_ResumeTick();
-  pwr_timestamp_log("nn inference");
-#else
-  /* npu clock scaling, run one inference per npu freq config */
-  runInference_freqScaling();
-#endif
+/**
+  * @brief  disable NPU clock and external memories
+  * @param  None
+  * @retval None
+  */
+static void npuDeConfig(void)
+{
   sysclk_NpuClockDisable();
   BSP_XSPI_NOR_DeInit(0);
 #if (USE_PSRAM == 1)
   BSP_XSPI_RAM_DeInit(0);
 #endif /* USE_PSRAM */
   __HAL_RCC_XSPIM_CLK_DISABLE();
+  extMemConfigured = 0;
 }
 
+#if (NPU_FRQ_SCALING == 0)
+/**
+  * @brief  run a dry run inference according to NN_WARMUP_POLICY, to warm-up
+  *         npu cache, cpu caches and external flash before the measured inference
+  * @param  None
+  * @retval 1 if a dry run has been done
+  */
+static int nn_warmup(void)
+{
+  int warmup;
 
+#if (NN_WARMUP_POLICY == NN_WARMUP_NONE)
+  warmup = 0;
+#elif (NN_WARMUP_POLICY == NN_WARMUP_FIRST_BOOT)
+  warmup = (nnTriggerCount == 0);
+#else
+  warmup = ((nnTriggerCount % NN_WARMUP_PERIOD) == 0);
+#endif
+  nnTriggerCount++;
+
+  if (warmup)
+  {
+    /* run NN inference (dry run)*/
+    HAL_SuspendTick();
+    NN_Run(&NN_Instance_Default);
+    HAL_ResumeTick();
+    pwr_timestamp_log("nn inference (dry run)");
+  }
+
+  return warmup;
+}
+#endif /* NPU_FRQ_SCALING */
+
+#if (STREAMING_MODE == 0)
 /**
-  * @brief  run post-processing
+  * @brief  infer stage: configures NPU and NPU memories and run inference. The stage
+  *         returns to the scheduler while the NPU runs an epoch and resumes on NPU event
+  * @param  events activating events
+  * @retval None
+  */
+static void inferStage(uint32_t events)
+{
+#if(NPU_FRQ_SCALING == 0)
+  static int nnRunning;
+  static int warm;
+
+  if (events & SCHED_EVT_FRAME_READY)
+  {
+    npuConfig();
+    npuSetInputBuffer(nn_in_buffer);
+    pwr_timestamp_log("NPU and NPU Rams config");
+
+    warm = nn_warmup();
+
+    /* run NN inference */
+    NN_Start(&NN_Instance_Default, NULL, NULL);
+    nnRunning = 1;
+  }
+
+  if (!nnRunning)
+  {
+    /* NPU event left by a blocking inference */
+    return;
+  }
+
+  if (NN_Poll(&NN_Instance_Default) == NN_POLL_BUSY)
+  {
+    SCHED_Expect(SCHED_EVT_NPU);
+    return;
+  }
+
+  nnRunning = 0;
+  pwr_timestamp_log(warm ? "nn inference" : "nn inference (cold)");
+#if (NN_CACHE_CHECK == 1)
+  NN_CacheCheck(&NN_Instance_Default);
+  pwr_timestamp_log("nn inference (cache check)");
+#endif
+#else
+  if (!(events & SCHED_EVT_FRAME_READY))
+  {
+    return;
+  }
+
+  npuConfig();
+  npuSetInputBuffer(nn_in_buffer);
+  pwr_timestamp_log("NPU and NPU Rams config");
+
+#if (CASCADE_MODE == 1)
+  /* npu clock scaling, detector runs at its own freq config */
+  cascadeRun(&NN_Instance_Default, CASCADE_DETECTOR_FREQ_STEP, "nn inference");
+#else
+  /* npu clock scaling, run one inference per npu freq config */
+  runInference_freqScaling();
+#endif
+#endif
+#if (CASCADE_MODE == 0)
+  npuDeConfig();
+#endif /* NPU kept configured for the classifier */
+
+  SCHED_Post(SCHED_EVT_NN_DONE);
+}
+
+/**
+  * @brief  postprocess stage
+  * @param  events activating events
+  * @retval None
+  */
+static void postprocessStage(uint32_t events)
+{
+  UNUSED(events);
+#if (CASCADE_MODE == 1)
+  int32_t error = app_postprocess_run((void **) nn_out, number_output, &pp_output, &pp_params);
+  UNUSED(error);
+  pwr_timestamp_log("post processing");
+
+  if (pp_output.nb_detect > 0)
+  {
+    /* detector fired, run the classifier on the same frame */
+    SCHED_Post(SCHED_EVT_CASCADE);
+    return;
+  }
+
+  cascadeSkips++;
+  pwr_timestamp_log("classifier skipped");
+  cascadeEnd();
+#elif (ROI_SECOND_PASS == 1)
+  if (roiPass == 0)
+  {
+    postProcessingRun();
+    roiFirstDetect = pp_output.nb_detect;
+    if (pp_output.nb_detect > 0)
+    {
+      /* keep the most confident detection for the ROI pass */
+      roiBox = pp_output.pOutBuff[0];
+      for (int i = 1; i < pp_output.nb_detect; i++)
+      {
+        if (pp_output.pOutBuff[i].conf > roiBox.conf)
+        {
+          roiBox = pp_output.pOutBuff[i];
+        }
+      }
+      /* timestamps keep running across both passes */
+      postProcessingRelease();
+      SCHED_Post(SCHED_EVT_ROI);
+      return;
+    }
+    postProcessingEnd();
+  }
+  else
+  {
+    postProcessing();
+    roiPass = 0;
+  }
+#else
+  postProcessing();
+#endif
+  SCHED_Post(SCHED_EVT_PP_DONE);
+}
+#endif /* STREAMING_MODE */
+
+#if (ROI_SECOND_PASS == 1)
+/**
+  * @brief  ROI stage: re-capture the frame cropped around the top detection of the
+  *         full frame pass, the ROI capture then runs the same stages as the full frame
+  * @param  events activating events
+  * @retval None
+  */
+static void roiStage(uint32_t events)
+{
+  UNUSED(events);
+
+  cameraInit();
+  CAM_NNPipe_SetRoi(roiBox.x_center, roiBox.y_center, roiBox.width, roiBox.height);
+  pwr_timestamp_log("ROI config");
+
+  roiPass = 1;
+  cameraCapture();
+}
+#endif /* ROI_SECOND_PASS */
+
+#if (CASCADE_MODE == 1)
+/**
+  * @brief  run one network of the cascade, applying its own NPU clock step when
+  *         NPU_FRQ_SCALING is enabled
+  * @param  instance network instance
+  * @param  freqStep index in frequencySteps
+  * @param  name timestamp step name
+  * @retval None
+  */
+static void cascadeRun(NN_Instance_TypeDef *instance, int freqStep, const char *name)
+{
+#if (NPU_FRQ_SCALING == 1)
+  assert(freqStep < sizeof(frequencySteps) / sizeof(frequencySteps[0]));
+  sysclk_NpuFreqScaling(&frequencySteps[freqStep]);
+  /* invalidate all caches before next inference */
+  npu_cache_invalidate();
+  SCB_CleanInvalidateDCache();
+  SCB_InvalidateICache();
+  pwr_timestamp_log("config npu clock scaling");
+#else
+  UNUSED(freqStep);
+#endif
+
+  HAL_SuspendTick();
+  NN_Run(instance);
+  HAL_ResumeTick();
+  pwr_timestamp_log(name);
+}
+
+/**
+  * @brief  cascade stage: run the classifier on the frame where the detector fired
+  * @param  events activating events
+  * @retval None
+  */
+static void cascadeStage(uint32_t events)
+{
+  const LL_Buffer_InfoTypeDef *cls_in_info = LL_ATON_Input_Buffers_Info_cascade();
+  const LL_Buffer_InfoTypeDef *cls_out_info = LL_ATON_Output_Buffers_Info_cascade();
+  const LL_Buffer_InfoTypeDef *det_in_info = LL_ATON_Input_Buffers_Info_Default();
+  uint32_t len;
+  int ret;
+
+  UNUSED(events);
+
+  /* classifier shares the capture buffer with the detector: it must read the NN pipe frame as
+   * is, interleaved NN_WIDTH x NN_HEIGHT pixels of NN_BPP bytes with the detector input type */
+  uint32_t nd = cls_in_info[0].mem_ndims;
+  assert(nd >= 3);
+  assert(cls_in_info[0].chpos == CHPos_Last);
+  assert(cls_in_info[0].mem_shape[nd - 3] == NN_HEIGHT);
+  assert(cls_in_info[0].mem_shape[nd - 2] == NN_WIDTH);
+  assert(cls_in_info[0].mem_shape[nd - 1] == NN_BPP);
+  assert((cls_in_info[0].type == det_in_info[0].type) && (cls_in_info[0].nbits == det_in_info[0].nbits));
+  len = LL_Buffer_len(&cls_in_info[0]);
+  assert(len == sizeof(nn_in_buffer));
+  UNUSED(nd);
+  UNUSED(det_in_info);
+  ret = LL_ATON_Set_User_Input_Buffer_cascade(0, nn_in_buffer, len);
+  assert(ret == LL_ATON_User_IO_NOERROR);
+
+  cascadeRun(&NN_Instance_cascade, CASCADE_CLASSIFIER_FREQ_STEP, "classifier inference");
+
+  /* arg max on classifier output */
+  uint8_t *out = (uint8_t *) LL_Buffer_addr_start(&cls_out_info[0]);
+  len = LL_Buffer_len(&cls_out_info[0]);
+  SCB_InvalidateDCache_by_Addr(out, len);
+  uint32_t nb = (cls_out_info[0].type == DataType_FLOAT) ? len / sizeof(float32_t) : len;
+  float32_t best = 0;
+  cascadeClass = -1;
+  for (uint32_t i = 0; i < nb; i++)
+  {
+    float32_t v;
+
+    if (cls_out_info[0].type == DataType_FLOAT)
+    {
+      v = ((float32_t *) out)[i];
+    }
+    else if (cls_out_info[0].type == DataType_INT8)
+    {
+      v = ((int8_t *) out)[i];
+    }
+    else
+    {
+      v = out[i];
+    }
+    if ((cascadeClass < 0) || (v > best))
+    {
+      best = v;
+      cascadeClass = i;
+    }
+  }
+  cascadeRuns++;
+  pwr_timestamp_log("classifier post processing");
+
+  cascadeEnd();
+  SCHED_Post(SCHED_EVT_PP_DONE);
+}
+
+/**
+  * @brief  release NPU, external memories and inference clocks at the end of the cascade
+  * @param  None
+  * @retval None
+  */
+static void cascadeEnd(void)
+{
+  npuDeConfig();
+#if (CLOCK_MANAGER == 1)
+  sysclk_ClockRelease(SYSCLK_CLOCK_NPU);
+#elif(POWER_OVERDRIVE == 1)
+  RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
+  HAL_RCC_GetClockConfig(&RCC_ClkInitStruct);
+  sysclk_NpuOverDrivePllDeinit(&RCC_ClkInitStruct);
+#endif
+  postProcessingEnd();
+}
+#endif /* CASCADE_MODE */
+
+#if (STREAMING_MODE == 1)
+/**
+  * @brief  sleep until the NN pipe delivers a new frame
+  * @param  None
+  * @retval locked capture buffer
+  */
+static uint8_t *streamingWaitFrame(void)
+{
+  uint8_t *frame;
+
+  HAL_SuspendTick();
+  while ((frame = CAM_NNPipe_GetFrame()) == NULL)
+  {
+#if (PWR_TIMESTAMP_BACKGROUND_DRAIN == 1) && (PWR_TIMESTAMP_BINARY == 1)
+    /* the CPU is not involved in the transfer: start one frame over UART DMA, the transfer
+       complete interrupt wakes-up the CPU to start the next one. ASCII lines are not sent
+       here as printf would delay the frame processing */
+    pwr_timestamp_drain_async(TIMESTAMP_DRAIN_CHUNK);
+#endif
+    HAL_PWR_EnterSLEEPMode(0, PWR_SLEEPENTRY_WFI);
+  }
+  HAL_ResumeTick();
+
+  return frame;
+}
+
+/**
+  * @brief  post-process the outputs of the previous frame (pp_in)
+  * @param  stepName name of the logged step
+  * @retval None
+  */
+static void streamingPostProcess(const char *stepName)
+{
+  int32_t error = app_postprocess_run((void **) pp_in, number_output, &pp_output, &pp_params);
+  UNUSED(error);
+  pwr_timestamp_log(stepName);
+  streamingPpPending = 0;
+}
+
+/**
+  * @brief  completion callback of a streamed inference: when another frame follows, the outputs
+  *         are handed over to the second output buffer set (pp_in) as the next inference
+  *         overwrites nn_out
+  * @param  nn_instance completed network instance
+  * @param  arg points to 1 if another frame follows
+  * @retval None
+  */
+static void streamingInferenceDone(NN_Instance_TypeDef *nn_instance, void *arg)
+{
+  UNUSED(nn_instance);
+
+  if (streamingPpPending)
+  {
+    /* the inference completed before the CPU was free: post-process the previous frame
+       now, pp_in is overwritten below */
+    streamingPostProcess("post processing (after inference)");
+    streamingPpSerial++;
+  }
+  if (!*(int *) arg)
+  {
+    return;
+  }
+
+  for (int j = 0; j < number_output; j++)
+  {
+    memcpy(pp_in[j], nn_out[j], nn_out_len[j]);
+    SCB_InvalidateDCache_by_Addr(nn_out[j], nn_out_len[j]);
+  }
+}
+
+/**
+  * @brief  run one inference asynchronously, post-processing of the previous frame runs on the
+  *         CPU while the NPU runs the hardware epochs
+  * @param  nextFrame 1 if another frame follows, the outputs are then handed over to pp_in
+  * @retval None
+  */
+static void streamingInference(int nextFrame)
+{
+  NN_Start(&NN_Instance_Default, streamingInferenceDone, &nextFrame);
+  while (NN_Poll(&NN_Instance_Default) == NN_POLL_BUSY)
+  {
+    if (streamingPpPending)
+    {
+      /* NPU is busy: use the CPU instead of waiting for the end of epoch event */
+      streamingPostProcess("post processing (overlapped)");
+    }
+    else
+    {
+      LL_ATON_OSAL_WFE();
+    }
+  }
+}
+
+/**
+  * @brief  pipelined processing of STREAMING_NB_FRAMES frames: the camera captures frame N+1
+  *         while the NPU runs frame N and the CPU post-processes frame N-1
+  * @param  None
+  * @retval None
+  */
+static void streamingPipeline(void)
+{
+  uint8_t *frame;
+  int warm;
+
+  cameraFrameReceived = 0;
+  streamingProcessed = 0;
+  streamingPpPending = 0;
+  streamingPpSerial = 0;
+  cameraSleepClocksEnable();
+
+  npuConfig();
+  npuSetInputBuffer(nn_in_buffer);
+  pwr_timestamp_log("NPU and NPU Rams config");
+
+  /* warm-up runs before the capture starts, on the previous content of the capture buffer */
+  warm = nn_warmup();
+
+  CAM_NNPipe_DoubleBufferStart(nn_in_buffer, nn_in_buffer_1, CMW_MODE_CONTINUOUS);
+  pwr_timestamp_log("camera started");
+
+  for (int i = 0; i < STREAMING_NB_FRAMES; i++)
+  {
+    frame = streamingWaitFrame();
+    pwr_timestamp_log("wait frame");
+
+    CAM_IspUpdate();
+    pwr_timestamp_log("ISP update");
+
+    npuSetInputBuffer(frame);
+    streamingInference(i < STREAMING_NB_FRAMES - 1);
+    CAM_NNPipe_ReleaseFrame();
+    streamingProcessed++;
+    /* only the first inference of the trigger can run cold */
+    pwr_timestamp_log(warm ? "nn inference" : "nn inference (cold)");
+    warm = 1;
+
+    /* outputs of this frame are post-processed during the next inference */
+    streamingPpPending = (i < STREAMING_NB_FRAMES - 1);
+  }
+
+  cameraDeInit();
+  npuDeConfig();
+
+  /* last frame is post-processed directly from nn_out */
+  postProcessing();
+}
+#endif /* STREAMING_MODE */
+
+
+#if (CASCADE_MODE == 0)
+/**
+  * @brief  run post-processing, then stop timestamps and restore clocks
   * @param  None
   * @retval None
   */
 static void postProcessing(void)
 {
-#if(POWER_OVERDRIVE == 1)
+  postProcessingRun();
+  postProcessingEnd();
+}
+
+/**
+  * @brief  run post-processing
+  * @param  None
+  * @retval None
+  */
+static void postProcessingRun(void)
+{
+#if (CLOCK_MANAGER == 1)
+  sysclk_ClockRelease(SYSCLK_CLOCK_NPU);
+#elif(POWER_OVERDRIVE == 1)
   RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
   HAL_RCC_GetClockConfig(&RCC_ClkInitStruct);
   sysclk_NpuOverDrivePllDeinit(&RCC_ClkInitStruct);
@@ -466,15 +1483,39 @@ static void postProcessing(void)
   int32_t error = app_postprocess_run((void **) nn_out, number_output, &pp_output, &pp_params);
   UNUSED(error);
   pwr_timestamp_log("post processing");
+}
+#endif /* CASCADE_MODE */
+
+/**
+  * @brief  stop timestamps and restore clocks after post-processing
+  * @param  None
+  * @retval None
+  */
+static void postProcessingEnd(void)
+{
   pwr_timestamp_stop();
+  postProcessingRelease();
+}
 
+/**
+  * @brief  discard nn outputs from data cache and restore clocks after post-processing
+  * @param  None
+  * @retval None
+  */
+static void postProcessingRelease(void)
+{
   /* Discard nn_out region (used by pp_input and pp_outputs variables) to avoid Dcache evictions during nn inference */
   for (int i = 0; i < number_output; i++)
   {
     float32_t *tmp = nn_out[i];
     SCB_InvalidateDCache_by_Addr(tmp, nn_out_len[i]);
   }
-#if(POWER_OVERDRIVE == 1)
+#if (CLOCK_MANAGER == 1)
+  /* NPU RAMs kept by the post-processing of nn_out */
+  sysclk_ClockRelease(SYSCLK_CLOCK_NPU_RAMS);
+#elif(POWER_OVERDRIVE == 1)
+  RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
+  HAL_RCC_GetClockConfig(&RCC_ClkInitStruct);
   sysclk_NpuRamsOverDriveClockDeinit(&RCC_ClkInitStruct);
 #endif
 
@@ -518,10 +1559,110 @@ static void postProcessing(void)
   */
 static void sendTimestamp(void)
 {
+#if (PWR_TIMESTAMP_BACKGROUND_DRAIN == 1)
+  /* the console is configured again: complete the frame in flight */
+  pwr_timestamp_drain_wait();
+#endif
   Console_Config();
+#if (STREAMING_MODE == 1)
+  CAM_NNPipeStats_t stats;
+  CAM_NNPipe_GetStats(&stats);
+  printf("streaming: %d frames processed, %lu captured, %lu pipe holds, %lu dropped, %lu post-processings not overlapped\r\n",
+         streamingProcessed, stats.frames, stats.suspends, stats.drops, streamingPpSerial);
+#endif /* STREAMING_MODE */
+#if (EXTMEM_EARLY_INIT == 1) && (STREAMING_MODE == 0)
+  printf("external memories init: %lu us, hidden by capture: %lu us\r\n", extMemInitTime, extMemHiddenTime);
+#endif /* EXTMEM_EARLY_INIT */
+#if (PERIODIC_CAPTURE == 1)
+  printf("periodic capture: frame %lu, period %d ms, wake-up %lu us, latency %lu us (min %lu, max %lu, jitter %lu us), %lu overruns\r\n",
+         periodicFrames, PERIODIC_CAPTURE_PERIOD_MS, periodicWakeup, periodicLatency,
+         periodicLatencyMin, periodicLatencyMax, periodicLatencyMax - periodicLatencyMin, periodicOverruns);
+#endif /* PERIODIC_CAPTURE */
+#if (CASCADE_MODE == 1)
+  printf("cascade: classifier run on %lu frames, skipped on %lu, last class %ld\r\n",
+         cascadeRuns, cascadeSkips, cascadeClass);
+#endif /* CASCADE_MODE */
+#if (MOTION_GATE == 1)
+  printf("motion gate: %lu changed cells (threshold %d), inference %s, %lu frames inferred, %lu skipped\r\n",
+         motionScore, MOTION_GATE_MIN_CELLS, motionSkipped ? "skipped" : "run", motionInferred, motionSkippedTotal);
+#endif /* MOTION_GATE */
+#if (ROI_SECOND_PASS == 1)
+  if (roiFirstDetect > 0)
+  {
+    uint32_t x, y, w, h;
+    CAM_NNPipe_GetRoi(&x, &y, &w, &h);
+    printf("roi second pass: %ld detections on full frame, roi %lux%lu at (%lu, %lu), %ld detections on roi\r\n",
+           roiFirstDetect, w, h, x, y, pp_output.nb_detect);
+  }
+  else
+  {
+    printf("roi second pass: no detection on full frame, skipped\r\n");
+  }
+#endif /* ROI_SECOND_PASS */
+#if (NPU_PROFILE != NPU_PROFILE_NONE)
+  NPU_PROFILE_Report();
+#endif /* NPU_PROFILE */
+#if (NN_EPOCH_FREQ_PLAN == 1)
+  NPU_FREQ_PLAN_Report();
+#endif /* NN_EPOCH_FREQ_PLAN */
+#if (CPU_FRQ_SCALE_DOWN_ADAPTIVE == 1)
+  NPU_WFE_Report();
+#endif /* CPU_FRQ_SCALE_DOWN_ADAPTIVE */
+#if (CLOCK_MANAGER == 1)
+  sysclk_ClockReport();
+#endif /* CLOCK_MANAGER */
+#if (NN_CACHE_CHECK == 1)
+  NN_CacheCheckReport();
+#endif /* NN_CACHE_CHECK */
+#if (SMPS_LATENCY_BUDGET_US > 0)
+  printf("smps schedule: %lu inferences at nominal (%lu us, budget %d us), %lu at overdrive\r\n",
+         smpsNominalRuns, smpsNominalUs, SMPS_LATENCY_BUDGET_US, smpsOverdriveRuns);
+#endif /* SMPS_LATENCY_BUDGET_US */
+#if (NPU_FRQ_SCALING == 1)
+  sysclk_NpuFreqScalingReport();
+  sysclk_SmpsReport();
+#endif /* NPU_FRQ_SCALING */
   pwr_timestamp_sendOverUart();
 }
 
+/**
+  * @brief  report stage: send timestamps, de-initialize IPs and wait for next trigger
+  * @param  events activating events
+  * @retval None
+  */
+static void reportStage(uint32_t events)
+{
+  UNUSED(events);
+
+#if (PERIODIC_CAPTURE == 1)
+  uint32_t idx;
+  uint32_t t = TIMER_Periodic_GetTime(&idx);
+
+  periodicLatency = (idx - periodicIdx) * PERIODIC_CAPTURE_PERIOD_MS * 1000 + t;
+  if (periodicLatency < periodicLatencyMin)
+  {
+    periodicLatencyMin = periodicLatency;
+  }
+  if (periodicLatency > periodicLatencyMax)
+  {
+    periodicLatencyMax = periodicLatency;
+  }
+  if (idx != periodicIdx)
+  {
+    periodicOverruns++;
+  }
+  periodicFrames++;
+#endif
+
+  /* Send timestamps */
+  sendTimestamp();
+
+  /* De-initialize IPs */
+  deInitIPs();
+
+  userTriggerArm();
+}
+
 /**
   * @brief  disable all used IPs and be ready for next capture
   * @param  None
@@ -592,8 +1733,10 @@ static void NPURam_disable(void)
   hramcfg.Instance =  RAMCFG_SRAM6_AXI;
   HAL_RAMCFG_DisableAXISRAM(&hramcfg);
 
+#if (NN_PERSISTENT_RUNTIME == 0)
   __HAL_RCC_NPU_FORCE_RESET();
   __HAL_RCC_NPU_RELEASE_RESET();
+#endif /* NN_PERSISTENT_RUNTIME: NPU state is kept, only its clock is gated */
   __HAL_RCC_NPU_CLK_DISABLE();
   __HAL_RCC_NPU_CLK_SLEEP_DISABLE();
 
@@ -759,7 +1902,7 @@ static void Console_Config(void)
   HAL_GPIO_Init(GPIOE, &gpio_init);
 
   huart1.Instance          = USART1;
-  huart1.Init.BaudRate     = 115200;
+  huart1.Init.BaudRate     = CONSOLE_BAUDRATE;
   huart1.Init.Mode         = UART_MODE_TX_RX;
   huart1.Init.Parity       = UART_PARITY_NONE;
   huart1.Init.WordLength   = UART_WORDLENGTH_8B;
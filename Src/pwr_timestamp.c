@@ -20,6 +20,7 @@
 
 #include "pwr_timestamp.h"
 #include "main.h"
+#include "app_config.h"
 
 /* Timer handle declaration */
 TIM_HandleTypeDef htim2;
@@ -27,44 +28,68 @@ TIM_HandleTypeDef htim2;
 /* Define the prescaler value for the timer */
 #define PRESCALER_VALUE (uint32_t)(((400000000) / (1000000)) - 1)
 
-/* Define the maximum number of log entries */
-#define MAX_LOG_ENTRIES 100
+/* Define the maximum number of log entries, must be a power of 2 (ring buffer) */
+#define MAX_LOG_ENTRIES 128
+#define LOG_INDEX_MASK  (MAX_LOG_ENTRIES - 1)
+
+/* Number of RCC enable registers logged per entry */
+#define LOG_NB_REGS 15
+
+/* log entry time: 64 bits ns in high resolution mode, TIM2 us counter otherwise */
+#if (PWR_TIMESTAMP_HIGHRES == 1)
+typedef uint64_t LogTime_t;
+#else
+typedef uint32_t LogTime_t;
+#endif
 
 /* structure for log entries */
 typedef struct 
 {
   const char* name;
-  uint32_t timestamp;
-
-      uint32_t divenr;
-      uint32_t miscenr;
-      uint32_t memenr;
-      uint32_t ahb1enr;
-      uint32_t ahb2enr;
-      uint32_t ahb3enr;
-      uint32_t ahb4enr;
-      uint32_t ahb5enr;
-      uint32_t apb1lenr;
-      uint32_t apb1henr;
-      uint32_t apb2enr;
-      uint32_t apb3enr;
-      uint32_t apb4lenr;
-      uint32_t apb4henr;
-      uint32_t apb5enr;
+  LogTime_t timestamp;
 
+  /* DIVENR, MISCENR, MEMENR, AHB1ENR..AHB5ENR, APB1LENR, APB1HENR, APB2ENR,
+   * APB3ENR, APB4LENR, APB4HENR, APB5ENR */
+  uint32_t enr[LOG_NB_REGS];
 } LogEntry_t;
 
 /* Buffer to store log entries */
 __attribute__ ((aligned (32)))
 LogEntry_t logBuffer[MAX_LOG_ENTRIES];
 
-/* Static variables to keep track of timer state and log index */
+/* Static variables to keep track of timer state */
 static uint32_t tim_started = 0;
-static uint32_t logIndex = 0;
+
+/* Ring buffer indexes, free running: entries logIn - logOut are pending. Producers
+ * (thread and interrupts) only write logIn, the consumer (drain) only writes logOut */
+static volatile uint32_t logIn = 0;
+static volatile uint32_t logOut = 0;
+/* entries dropped because the ring buffer was full */
+static volatile uint32_t logOverruns = 0;
+
+#if (PWR_TIMESTAMP_HIGHRES == 1)
+/* High resolution timestamps: time in ns extrapolated from the DWT cycle counter since
+ * the last TIM2 tick sampled (hrBaseNs, hrBaseCyc). CYCCNT is stopped while the CPU
+ * sleeps and its rate follows the CPU clock, so an estimate not matching the current
+ * TIM2 us period (within HR_SLACK_NS) triggers a new alignment on TIM2 */
+#define HR_SLACK_NS 50
+static uint64_t hrBaseNs = 0;
+static uint32_t hrBaseCyc = 0;
+/* ns per CPU cycle, Q24 fixed point */
+static uint32_t hrNsPerCycle = 0;
+#define LOG_UNIT "ns"
+/* printf of nano.specs has no 64 bits integers: seconds then 9 digits of ns */
+#define LOG_TIME "%lu%09lu"
+#define LOG_TIME_ARGS(t) (uint32_t) ((t) / 1000000000ULL), (uint32_t) ((t) % 1000000000ULL)
+#else
+#define LOG_UNIT "us"
+#define LOG_TIME "%lu"
+#define LOG_TIME_ARGS(t) (t)
+#endif /* PWR_TIMESTAMP_HIGHRES */
 
 /* Define constants for log formatting */
 #define MAX_FORMATTED_RECORD_LENGTH 100
-#define LOG_FORMAT "[SLP_SOL]%.30s:%lu:us:" \
+#define LOG_FORMAT "[SLP_SOL]%.30s:" LOG_TIME ":" LOG_UNIT ":" \
                    "DIVENR=%lu:" \
                    "MISCENR=%lu:" \
                    "MEMENR=%lu:" \
@@ -82,6 +107,33 @@ static uint32_t logIndex = 0;
                    "APB5ENR=%lu[SLP_EOL]"
 #define END_OF_LOG "[SLP_SOL]END_OF_LOG[SLP_EOL]\0"
 
+#if (PWR_TIMESTAMP_BINARY == 1)
+/* Binary log frame:
+ *   sync (0xA5 0x5A), version, payload length (16 bits LE), payload, CRC16-CCITT (LE) of
+ *   version, length and payload.
+ * Payload: number of records, timestamp unit (0: us, 1: ns), then for each record:
+ *   name index; a new name is defined when the index equals the number of names
+ *   already defined in the frame, it is followed by the name length and characters
+ *   timestamp delta to the previous record, unsigned LEB128
+ *   16 bits mask (LE) of the registers which changed since previous record (all
+ *   registers are 0 before the first record), then the changed registers (32 bits LE)
+ */
+#define BIN_SYNC0          0xA5
+#define BIN_SYNC1          0x5A
+#define BIN_VERSION        2
+#define BIN_HEADER_SIZE    5
+#define BIN_NAME_MAX       30
+#define BIN_RECORD_MAX     (1 + 1 + BIN_NAME_MAX + 10 + 2 + 4 * LOG_NB_REGS)
+#define BIN_FRAME_MAX      (BIN_HEADER_SIZE + 2 + MAX_LOG_ENTRIES * BIN_RECORD_MAX + 2)
+
+__attribute__ ((aligned (32)))
+static uint8_t binFrame[(BIN_FRAME_MAX + 31) & ~31];
+DMA_HandleTypeDef hdma_usart1_tx;
+extern UART_HandleTypeDef huart1;
+/* Entries of the frame sent in background, 0 when no transfer is in flight */
+static volatile uint32_t binAsyncCount = 0;
+#endif /* PWR_TIMESTAMP_BINARY */
+
 /**
   * @brief Function to initialize the timer
   * @retval None
@@ -123,6 +175,90 @@ static void timer_init(void)
   }
 }
 
+#if (PWR_TIMESTAMP_HIGHRES == 1)
+/**
+  * @brief Enable the DWT cycle counter
+  * @retval None
+  */
+static void hr_init(void)
+{
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+  * @brief Align the cycle counter on a TIM2 tick and read the current CPU frequency.
+  *        Called with interrupts disabled
+  * @retval None
+  */
+static void hr_sync(void)
+{
+  uint32_t tim = __HAL_TIM_GET_COUNTER(&htim2);
+
+  if (tim_started)
+  {
+    /* wait for the next tick, at most 1 us */
+    uint32_t next;
+    while ((next = __HAL_TIM_GET_COUNTER(&htim2)) == tim);
+    tim = next;
+  }
+  hrBaseCyc = DWT->CYCCNT;
+  hrBaseNs = (uint64_t) tim * 1000;
+  hrNsPerCycle = (uint32_t) ((1000000000ULL << 24) / HAL_RCC_GetCpuClockFreq());
+}
+
+/**
+  * @brief Current time in ns, called with interrupts disabled
+  * @retval time in ns since pwr_timestamp_start
+  */
+static uint64_t hr_get(void)
+{
+  uint64_t timNs = (uint64_t) __HAL_TIM_GET_COUNTER(&htim2) * 1000;
+  uint64_t ns = hrBaseNs + (((uint64_t) (DWT->CYCCNT - hrBaseCyc) * hrNsPerCycle) >> 24);
+
+  /* ns must be in the current TIM2 period [timNs, timNs + 1000[ */
+  if ((ns - timNs + HR_SLACK_NS) >= 1000 + 2 * HR_SLACK_NS)
+  {
+    hr_sync();
+    ns = hrBaseNs;
+  }
+
+  return ns;
+}
+
+/**
+  * @brief Align the high resolution timestamps after a CPU clock change. Few cycles ran
+  *        since the change, so the time is extrapolated with the previous CPU frequency and
+  *        only the rate is updated: frequent switches (CPU_FRQ_SCALE_DOWN around each NPU
+  *        wait) do not busy-wait for a TIM2 tick. hr_get still aligns on TIM2, waiting up
+  *        to 1 us, when the extrapolation is out of the current TIM2 period (after a sleep)
+  * @retval None
+  */
+void pwr_timestamp_cpu_clock_changed(void)
+{
+  /* clock configured before pwr_timestamp_init */
+  if (htim2.Instance == NULL)
+  {
+    return;
+  }
+
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (hrNsPerCycle == 0)
+  {
+    hr_sync();
+  }
+  else
+  {
+    hrBaseNs = hr_get();
+    hrBaseCyc = DWT->CYCCNT;
+    hrNsPerCycle = (uint32_t) ((1000000000ULL << 24) / HAL_RCC_GetCpuClockFreq());
+  }
+  __set_PRIMASK(primask);
+}
+#endif /* PWR_TIMESTAMP_HIGHRES */
+
 /**
   * @brief Function to start the timestamping
   * @retval None
@@ -134,11 +270,13 @@ void pwr_timestamp_start(void)
     tim_started = 1;
     __HAL_TIM_SET_COUNTER(&htim2, 0);
   }
-  /* Reset variables */
-  logIndex = 0;
-  
   /* Start timer */
   HAL_TIM_Base_Start(&htim2);
+#if (PWR_TIMESTAMP_HIGHRES == 1)
+  /* TIM2 was stopped or reset: full alignment */
+  hrNsPerCycle = 0;
+  pwr_timestamp_cpu_clock_changed();
+#endif
 }
 
 /**
@@ -160,6 +298,9 @@ void pwr_timestamp_init(void)
 {
   /* Configure timer */
   timer_init();
+#if (PWR_TIMESTAMP_HIGHRES == 1)
+  hr_init();
+#endif
   
   /* Clear buffer */
   memset(logBuffer, 0, sizeof(logBuffer));
@@ -172,28 +313,405 @@ void pwr_timestamp_init(void)
   */
 void pwr_timestamp_log(const char *stepName)
 {
-  assert(logIndex < MAX_LOG_ENTRIES);
-  
-  uint32_t timer_cnt_val = __HAL_TIM_GET_COUNTER(&htim2);
-  
-  logBuffer[logIndex].name = stepName;
-  logBuffer[logIndex].timestamp = timer_cnt_val;
-  logBuffer[logIndex].divenr = RCC->DIVENR;
-  logBuffer[logIndex].miscenr = RCC->MISCENR;
-  logBuffer[logIndex].memenr = RCC->MEMENR;
-  logBuffer[logIndex].ahb1enr = RCC->AHB1ENR;
-  logBuffer[logIndex].ahb2enr = RCC->AHB2ENR;
-  logBuffer[logIndex].ahb3enr = RCC->AHB3ENR;
-  logBuffer[logIndex].ahb4enr = RCC->AHB4ENR;
-  logBuffer[logIndex].ahb5enr = RCC->AHB5ENR;
-  logBuffer[logIndex].apb1lenr = RCC->APB1ENR1;
-  logBuffer[logIndex].apb1henr = RCC->APB1ENR2;
-  logBuffer[logIndex].apb2enr = RCC->APB2ENR;
-  logBuffer[logIndex].apb3enr = RCC->APB3ENR;
-  logBuffer[logIndex].apb4lenr = RCC->APB4ENR1;
-  logBuffer[logIndex].apb4henr = RCC->APB4ENR2;
-  logBuffer[logIndex].apb5enr = RCC->APB5ENR;
-  logIndex++;
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+
+  if (logIn - logOut >= MAX_LOG_ENTRIES)
+  {
+    logOverruns++;
+    __set_PRIMASK(primask);
+    return;
+  }
+
+  LogEntry_t *entry = &logBuffer[logIn & LOG_INDEX_MASK];
+  entry->name = stepName;
+#if (PWR_TIMESTAMP_HIGHRES == 1)
+  entry->timestamp = hr_get();
+#else
+  entry->timestamp = __HAL_TIM_GET_COUNTER(&htim2);
+#endif
+  entry->enr[0] = RCC->DIVENR;
+  entry->enr[1] = RCC->MISCENR;
+  entry->enr[2] = RCC->MEMENR;
+  entry->enr[3] = RCC->AHB1ENR;
+  entry->enr[4] = RCC->AHB2ENR;
+  entry->enr[5] = RCC->AHB3ENR;
+  entry->enr[6] = RCC->AHB4ENR;
+  entry->enr[7] = RCC->AHB5ENR;
+  entry->enr[8] = RCC->APB1ENR1;
+  entry->enr[9] = RCC->APB1ENR2;
+  entry->enr[10] = RCC->APB2ENR;
+  entry->enr[11] = RCC->APB3ENR;
+  entry->enr[12] = RCC->APB4ENR1;
+  entry->enr[13] = RCC->APB4ENR2;
+  entry->enr[14] = RCC->APB5ENR;
+  /* publish the entry to the consumer */
+  __DMB();
+  logIn++;
+
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief Function to read the current timestamp without logging it
+  * @retval time in us since pwr_timestamp_start
+  */
+uint32_t pwr_timestamp_get(void)
+{
+  return __HAL_TIM_GET_COUNTER(&htim2);
+}
+
+/**
+  * @brief Function to read the current timestamp in ns without logging it, the
+  *        resolution is 1 us unless PWR_TIMESTAMP_HIGHRES is enabled
+  * @retval low 32 bits of the time in ns since pwr_timestamp_start, wraps after 4.29 s:
+  *         use the difference of two calls to measure durations below that
+  */
+uint32_t pwr_timestamp_get_ns(void)
+{
+#if (PWR_TIMESTAMP_HIGHRES == 1)
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  uint32_t ns = (uint32_t) hr_get();
+  __set_PRIMASK(primask);
+
+  return ns;
+#else
+  return __HAL_TIM_GET_COUNTER(&htim2) * 1000;
+#endif
+}
+
+#if (PWR_TIMESTAMP_BINARY == 1)
+/**
+  * @brief CRC16-CCITT (poly 0x1021, init 0xFFFF)
+  * @param data data to protect
+  * @param len data length
+  * @retval crc
+  */
+static uint16_t bin_crc16(const uint8_t *data, uint32_t len)
+{
+  uint16_t crc = 0xFFFF;
+
+  for (uint32_t i = 0; i < len; i++)
+  {
+    crc ^= (uint16_t) data[i] << 8;
+    for (int b = 0; b < 8; b++)
+    {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+  }
+
+  return crc;
+}
+
+/**
+  * @brief Encode logged entries in a binary frame, an empty frame ends the log
+  * @param frame output buffer of BIN_FRAME_MAX bytes
+  * @param first ring buffer index of the first entry
+  * @param count number of entries
+  * @retval frame length
+  */
+static uint32_t bin_encode(uint8_t *frame, uint32_t first, uint32_t count)
+{
+  const char *names[MAX_LOG_ENTRIES];
+  uint32_t regs[LOG_NB_REGS] = {0};
+  LogTime_t prevTimestamp = 0;
+  uint32_t nbNames = 0;
+  uint8_t *p = &frame[BIN_HEADER_SIZE];
+
+  *p++ = count;
+  *p++ = PWR_TIMESTAMP_HIGHRES;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    LogEntry_t *entry = &logBuffer[(first + i) & LOG_INDEX_MASK];
+    uint32_t idx;
+
+    /* name, sent once per frame */
+    for (idx = 0; idx < nbNames; idx++)
+    {
+      if (names[idx] == entry->name)
+      {
+        break;
+      }
+    }
+    *p++ = idx;
+    if (idx == nbNames)
+    {
+      uint32_t len = strnlen(entry->name, BIN_NAME_MAX);
+      names[nbNames++] = entry->name;
+      *p++ = len;
+      memcpy(p, entry->name, len);
+      p += len;
+    }
+
+    /* timestamp delta */
+    LogTime_t delta = entry->timestamp - prevTimestamp;
+    prevTimestamp = entry->timestamp;
+    do
+    {
+      *p++ = (delta & 0x7F) | ((delta > 0x7F) ? 0x80 : 0);
+      delta >>= 7;
+    } while (delta);
+
+    /* changed registers */
+    uint8_t *mask = p;
+    uint16_t changed = 0;
+    p += 2;
+    for (int r = 0; r < LOG_NB_REGS; r++)
+    {
+      if (entry->enr[r] != regs[r])
+      {
+        regs[r] = entry->enr[r];
+        changed |= 1U << r;
+        memcpy(p, &regs[r], 4);
+        p += 4;
+      }
+    }
+    mask[0] = changed & 0xFF;
+    mask[1] = changed >> 8;
+  }
+
+  uint32_t payload = p - &frame[BIN_HEADER_SIZE];
+  frame[0] = BIN_SYNC0;
+  frame[1] = BIN_SYNC1;
+  frame[2] = BIN_VERSION;
+  frame[3] = payload & 0xFF;
+  frame[4] = payload >> 8;
+  uint16_t crc = bin_crc16(&frame[2], BIN_HEADER_SIZE - 2 + payload);
+  *p++ = crc & 0xFF;
+  *p++ = crc >> 8;
+
+  return p - frame;
+}
+
+/**
+  * @brief Configure GPDMA1 channel 0 for USART1 transmission
+  * @retval None
+  */
+static void bin_dma_init(void)
+{
+  __HAL_RCC_GPDMA1_CLK_ENABLE();
+
+  hdma_usart1_tx.Instance = GPDMA1_Channel0;
+  hdma_usart1_tx.Init.Request = GPDMA1_REQUEST_USART1_TX;
+  hdma_usart1_tx.Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+  hdma_usart1_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  hdma_usart1_tx.Init.SrcInc = DMA_SINC_INCREMENTED;
+  hdma_usart1_tx.Init.DestInc = DMA_DINC_FIXED;
+  hdma_usart1_tx.Init.SrcDataWidth = DMA_SRC_DATAWIDTH_BYTE;
+  hdma_usart1_tx.Init.DestDataWidth = DMA_DEST_DATAWIDTH_BYTE;
+  hdma_usart1_tx.Init.Priority = DMA_LOW_PRIORITY_LOW_WEIGHT;
+  hdma_usart1_tx.Init.SrcBurstLength = 1;
+  hdma_usart1_tx.Init.DestBurstLength = 1;
+  hdma_usart1_tx.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0;
+  hdma_usart1_tx.Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+  hdma_usart1_tx.Init.Mode = DMA_NORMAL;
+  if (HAL_DMA_Init(&hdma_usart1_tx) != HAL_OK)
+  {
+    while(1);
+  }
+  if (HAL_DMA_ConfigChannelAttributes(&hdma_usart1_tx, DMA_CHANNEL_SEC | DMA_CHANNEL_PRIV |
+                                      DMA_CHANNEL_SRC_SEC | DMA_CHANNEL_DEST_SEC) != HAL_OK)
+  {
+    while(1);
+  }
+  __HAL_LINKDMA(&huart1, hdmatx, hdma_usart1_tx);
+
+  HAL_NVIC_SetPriority(GPDMA1_Channel0_IRQn, 0xFF, 0);
+  HAL_NVIC_EnableIRQ(GPDMA1_Channel0_IRQn);
+  HAL_NVIC_SetPriority(USART1_IRQn, 0xFF, 0);
+  HAL_NVIC_EnableIRQ(USART1_IRQn);
+}
+
+/**
+  * @brief Release GPDMA1 channel 0
+  * @retval None
+  */
+static void bin_dma_deinit(void)
+{
+  HAL_NVIC_DisableIRQ(USART1_IRQn);
+  HAL_NVIC_DisableIRQ(GPDMA1_Channel0_IRQn);
+  HAL_DMA_DeInit(&hdma_usart1_tx);
+  __HAL_RCC_GPDMA1_CLK_DISABLE();
+}
+
+/**
+  * @brief Start the transfer of a binary frame over UART DMA
+  * @param first ring buffer index of the first entry
+  * @param count number of entries
+  * @retval None
+  */
+static void bin_start(uint32_t first, uint32_t count)
+{
+  uint32_t len = bin_encode(binFrame, first, count);
+  SCB_CleanDCache_by_Addr((uint32_t *) binFrame, sizeof(binFrame));
+
+  bin_dma_init();
+  if (HAL_UART_Transmit_DMA(&huart1, binFrame, len) != HAL_OK)
+  {
+    while(1);
+  }
+}
+
+/**
+  * @brief Send a binary frame over UART DMA, the CPU sleeps during the transfer
+  * @param first ring buffer index of the first entry
+  * @param count number of entries
+  * @retval None
+  */
+static void bin_send(uint32_t first, uint32_t count)
+{
+  bin_start(first, count);
+  /* sleep until the transfer is completed, interrupts are served once PRIMASK is cleared */
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  while (huart1.gState != HAL_UART_STATE_READY)
+  {
+    __WFI();
+    __enable_irq();
+    __disable_irq();
+  }
+  __set_PRIMASK(primask);
+  bin_dma_deinit();
+}
+
+/**
+  * @brief UART transmit complete callback: release the entries of a background transfer
+  * @param huart UART handle
+  * @retval None
+  */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  if ((huart == &huart1) && (binAsyncCount != 0))
+  {
+    bin_dma_deinit();
+    /* release the slots to the producers */
+    __DMB();
+    logOut += binAsyncCount;
+    binAsyncCount = 0;
+  }
+}
+#endif /* PWR_TIMESTAMP_BINARY */
+
+/**
+  * @brief Number of logged entries not sent yet
+  * @retval pending entries
+  */
+uint32_t pwr_timestamp_pending(void)
+{
+  return logIn - logOut;
+}
+
+/**
+  * @brief Send pending entries over UART, the console must be configured. Entries
+  *        can be logged (from thread or interrupt) while draining
+  * @param max_entries maximum number of entries to send
+  * @retval None
+  */
+void pwr_timestamp_drain(uint32_t max_entries)
+{
+  uint32_t count;
+
+  /* logOut is only written by one consumer at a time */
+  pwr_timestamp_drain_wait();
+  count = logIn - logOut;
+
+  if (count > max_entries)
+  {
+    count = max_entries;
+  }
+  if (count == 0)
+  {
+    return;
+  }
+  /* entries published before logIn was read */
+  __DMB();
+
+#if (PWR_TIMESTAMP_BINARY == 1)
+  bin_send(logOut, count);
+#else
+  for (uint32_t i = 0; i < count; i++)
+  {
+    LogEntry_t *entry = &logBuffer[(logOut + i) & LOG_INDEX_MASK];
+
+    printf(LOG_FORMAT "\n", entry->name, LOG_TIME_ARGS(entry->timestamp),
+           entry->enr[0], entry->enr[1], entry->enr[2], entry->enr[3], entry->enr[4],
+           entry->enr[5], entry->enr[6], entry->enr[7], entry->enr[8], entry->enr[9],
+           entry->enr[10], entry->enr[11], entry->enr[12], entry->enr[13], entry->enr[14]);
+  }
+#endif /* PWR_TIMESTAMP_BINARY */
+
+  /* release the slots to the producers */
+  __DMB();
+  logOut += count;
+}
+
+/**
+  * @brief Start sending pending entries without waiting, the console must be configured.
+  *        In binary mode, one frame is sent over UART DMA and the entries are released by
+  *        the transmit complete interrupt, nothing is started while a frame is in flight.
+  *        In ASCII mode, the entries are printed before returning.
+  * @param max_entries maximum number of entries to send
+  * @retval None
+  */
+void pwr_timestamp_drain_async(uint32_t max_entries)
+{
+#if (PWR_TIMESTAMP_BINARY == 1)
+  uint32_t count;
+
+  if (binAsyncCount != 0)
+  {
+    return;
+  }
+  count = logIn - logOut;
+  if (count > max_entries)
+  {
+    count = max_entries;
+  }
+  if (count == 0)
+  {
+    return;
+  }
+  /* entries published before logIn was read */
+  __DMB();
+  binAsyncCount = count;
+  bin_start(logOut, count);
+#else
+  pwr_timestamp_drain(max_entries);
+#endif /* PWR_TIMESTAMP_BINARY */
+}
+
+/**
+  * @brief Check if a frame started by pwr_timestamp_drain_async() is in flight
+  * @retval 1 if USART1 and GPDMA1 are busy, 0 otherwise
+  */
+uint32_t pwr_timestamp_drain_busy(void)
+{
+#if (PWR_TIMESTAMP_BINARY == 1)
+  return (binAsyncCount != 0) ? 1 : 0;
+#else
+  return 0;
+#endif /* PWR_TIMESTAMP_BINARY */
+}
+
+/**
+  * @brief Sleep until the frame started by pwr_timestamp_drain_async() is sent
+  * @retval None
+  */
+void pwr_timestamp_drain_wait(void)
+{
+#if (PWR_TIMESTAMP_BINARY == 1)
+  /* interrupts are served once PRIMASK is cleared */
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  while (binAsyncCount != 0)
+  {
+    __WFI();
+    __enable_irq();
+    __disable_irq();
+  }
+  __set_PRIMASK(primask);
+#endif /* PWR_TIMESTAMP_BINARY */
 }
 
 /**
@@ -206,17 +724,17 @@ void pwr_timestamp_sendOverUart(void)
   pwr_timestamp_stop();
   tim_started = 0;
   
-  for (int i = 0; i < logIndex; i++) 
+  pwr_timestamp_drain(MAX_LOG_ENTRIES);
+  if (logOverruns)
   {
-      printf(LOG_FORMAT "\n", logBuffer[i].name, logBuffer[i].timestamp,
-             logBuffer[i].divenr, logBuffer[i].miscenr, logBuffer[i].memenr,
-             logBuffer[i].ahb1enr, logBuffer[i].ahb2enr, logBuffer[i].ahb3enr,
-             logBuffer[i].ahb4enr, logBuffer[i].ahb5enr, logBuffer[i].apb1lenr,
-             logBuffer[i].apb1henr, logBuffer[i].apb2enr, logBuffer[i].apb3enr,
-             logBuffer[i].apb4lenr, logBuffer[i].apb4henr, logBuffer[i].apb5enr);
+    printf("timestamp log: %lu entries dropped (ring buffer full)\r\n", logOverruns);
+    logOverruns = 0;
   }
+
   /* send end of log command */
+#if (PWR_TIMESTAMP_BINARY == 1)
+  bin_send(0, 0);
+#else
   printf("%s\r\n", END_OF_LOG);
-  
-  logIndex = 0;
+#endif /* PWR_TIMESTAMP_BINARY */
 }
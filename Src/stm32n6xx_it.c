@@ -21,6 +21,13 @@
 #include "stm32n6xx_it.h"
 
 #include "cmw_camera.h"
+#include "app_timer.h"
+#include "app_config.h"
+
+#if (PWR_TIMESTAMP_BINARY == 1)
+extern DMA_HandleTypeDef hdma_usart1_tx;
+extern UART_HandleTypeDef huart1;
+#endif
 
 /**
   * @brief   This function handles NMI exception.
@@ -161,3 +168,20 @@ void EXTI13_IRQHandler(void)
 {
   HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_13);
 }
+
+void LPTIM1_IRQHandler(void)
+{
+  TIMER_Periodic_IRQHandler();
+}
+
+#if (PWR_TIMESTAMP_BINARY == 1)
+void GPDMA1_Channel0_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart1_tx);
+}
+
+void USART1_IRQHandler(void)
+{
+  HAL_UART_IRQHandler(&huart1);
+}
+#endif /* PWR_TIMESTAMP_BINARY */
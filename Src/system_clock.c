@@ -24,6 +24,7 @@
 #include "app_config.h"
 #include "stm32n6570_discovery.h"
 #include "main.h"
+#include "pwr_timestamp.h"
 
 /**
  * Clock initialization function based on the selected power mode.
@@ -92,6 +93,102 @@
 */
 
 
+#if (NPU_FRQ_SCALING == 1)
+/* frequency steps known by the NPU frequency scaling, frequencySteps and DVFS operating points */
+#define SYSCLK_MAX_STEPS 40
+
+/* IC dividers used while a PLL feeding the CPU, the NPU or the NPU RAMs is relocked */
+#define SYSCLK_PARK_CPU_DIV  2
+#define SYSCLK_PARK_NPU_DIV  200
+
+/* step register values, built once, and switch latency of the step */
+typedef struct
+{
+  const FrequencyStep *step;
+#if (NPU_FRQ_FAST_SWITCH == 1)
+  uint32_t pllCfgr1[2];  /* PLL2, PLL3 source, DIVM and DIVN */
+  uint32_t pllCfgr2[2];  /* PLL2, PLL3 DIVNFRAC */
+  uint32_t pllCfgr3[2];  /* PLL2, PLL3 PDIV1 and PDIV2 */
+  uint32_t icCfgr[3];    /* IC1 (CPU), IC6 (NPU), IC11 (NPU RAMs) */
+#endif
+  uint32_t switches;
+  uint32_t ns;
+  uint32_t maxNs;
+} SysclkStep;
+
+static SysclkStep sysclkSteps[SYSCLK_MAX_STEPS];
+static uint32_t sysclkNbSteps;
+#endif /* NPU_FRQ_SCALING */
+
+/* SMPS output, unknown until first configured */
+static int32_t smpsVoltage = -1;
+
+/* settle time of an SMPS transition without power-good wait, and power-good timeout */
+#define SYSCLK_SMPS_SETTLE_MS  10
+
+/* SMPS transitions to an output, and requests served without transition */
+typedef struct
+{
+  uint32_t transitions;
+  uint32_t avoided;
+  uint32_t settleNs;
+  uint32_t maxNs;
+} SysclkSmps;
+
+static SysclkSmps smpsStats[2];   /* SMPS_VOLTAGE_NOMINAL, SMPS_VOLTAGE_OVERDRIVE */
+static uint32_t smpsHold;         /* overdrive kept by sysclk_SmpsHoldOverdrive */
+static uint32_t smpsNominalPending;
+
+#if (CLOCK_MANAGER == 1)
+/* IC divider of a managed clock while its PLL is off */
+#define SYSCLK_PARK_DIV  200
+
+/* overdrive PLL powered while one of its clocks is required, PLL1 clocks the CPU and the
+ * buses and is never powered down */
+typedef struct
+{
+  const char *name;
+  uint32_t pll;        /* PLL index, 1: PLL2, 2: PLL3 */
+  uint32_t cfgr1;      /* source, DIVM and DIVN */
+  uint32_t cfgr3;      /* PDIV1 and PDIV2 */
+  uint32_t refs;       /* required clocks fed by the PLL */
+  uint32_t on;         /* 1 once started, locked or not */
+  uint32_t onStart;    /* us, start of the sequence if the PLL was already on */
+  uint32_t onUs;       /* time powered */
+  uint32_t lockStart;  /* ns, start of the PLL */
+  uint32_t locks;
+  uint32_t lockNs;     /* start to lock, when the lock was waited for */
+  uint32_t waitNs;     /* time waiting for the lock */
+} SysclkPll;
+
+/* clock fed by an IC divider, bit n of the clocks masks */
+typedef struct
+{
+  __IO uint32_t *icCfgr;
+  uint32_t icSource;
+  SysclkPll *pll;
+  uint32_t refs;
+} SysclkClock;
+
+static SysclkPll sysclkPlls[] =
+{
+  /* PLL2 = 48 * 125 / 6 = 1000MHz */
+  {"PLL2", 1, RCC_PLLSOURCE_HSE | (6 << RCC_PLL1CFGR1_PLL1DIVM_Pos) | (125 << RCC_PLL1CFGR1_PLL1DIVN_Pos),
+   (1 << RCC_PLL1CFGR3_PLL1PDIV1_Pos) | (1 << RCC_PLL1CFGR3_PLL1PDIV2_Pos)},
+  /* PLL3 = 48 x 75 / 4 = 900MHz */
+  {"PLL3", 2, RCC_PLLSOURCE_HSE | (4 << RCC_PLL1CFGR1_PLL1DIVM_Pos) | (75 << RCC_PLL1CFGR1_PLL1DIVN_Pos),
+   (1 << RCC_PLL1CFGR3_PLL1PDIV1_Pos) | (1 << RCC_PLL1CFGR3_PLL1PDIV2_Pos)},
+};
+
+static SysclkClock sysclkClocks[] =
+{
+  /* NPU Clock (sysc_ck) = ic6_ck = PLL2 output/1 = 1000 MHz */
+  {&RCC->IC6CFGR, RCC_ICCLKSOURCE_PLL2, &sysclkPlls[0]},
+  /* AXISRAM3/4/5/6 Clock (sysd_ck) = ic11_ck = PLL3 output/1 = 900 MHz */
+  {&RCC->IC11CFGR, RCC_ICCLKSOURCE_PLL3, &sysclkPlls[1]},
+};
+#endif /* CLOCK_MANAGER */
+
 /**
   * @brief Congigure external SMPS power mode
   * @param SMPSVoltage_TypeDef voltMode nominal or overdrive
@@ -100,7 +197,105 @@
 static void configPowerMode(SMPSVoltage_TypeDef voltMode)
 {
   BSP_SMPS_Init(voltMode);
-  HAL_Delay(10);
+#if (SMPS_POWER_GOOD_WAIT == 1)
+  /* lowering VddCore needs no wait, the clocks are already at nominal frequencies. Raising it
+   * waits for VddCore above the VOS0 low level of the VddCORE monitor, kept enabled */
+  if (voltMode == SMPS_VOLTAGE_OVERDRIVE)
+  {
+    PWR_VddCOREVMTypeDef vm = {0};
+    uint32_t tickstart = HAL_GetTick();
+
+    if (READ_BIT(PWR->CR3, PWR_CR3_VCOREMONEN) == 0U)
+    {
+      __HAL_RCC_PWR_CLK_ENABLE();
+      vm.LowVoltageThreshold = PWR_VDDCORE_THRESHOLD_VOS0;
+      vm.Mode = PWR_VDDCOREVM_MODE_NORMAL;
+      HAL_PWREx_ConfigVDDCOREVM(&vm);
+      HAL_PWREx_EnableVDDCOREMonitoring();
+    }
+    while ((HAL_PWREx_GetVDDCORELevel() == PWR_VDDCORE_BELOW_LOW_THRESHOLD)
+           && ((HAL_GetTick() - tickstart) < SYSCLK_SMPS_SETTLE_MS));
+  }
+#else
+  HAL_Delay(SYSCLK_SMPS_SETTLE_MS);
+#endif
+  smpsVoltage = voltMode;
+}
+
+/**
+  * @brief Request the SMPS output of the next clocks: no transition when the output is
+  *        already delivered, and no transition to nominal while overdrive is held. The
+  *        settle time of the transitions is measured with the timestamp timer
+  * @param voltMode nominal or overdrive
+  * @retval None
+  */
+static void smpsRequest(SMPSVoltage_TypeDef voltMode)
+{
+  SysclkSmps *stats = &smpsStats[voltMode == SMPS_VOLTAGE_OVERDRIVE];
+  uint32_t start;
+  uint32_t elapsed;
+
+  smpsNominalPending = 0;
+  if (smpsVoltage == voltMode)
+  {
+    stats->avoided++;
+    return;
+  }
+  if ((voltMode == SMPS_VOLTAGE_NOMINAL) && smpsHold && (smpsVoltage == SMPS_VOLTAGE_OVERDRIVE))
+  {
+    /* nominal frequencies run at overdrive until the hold is released */
+    stats->avoided++;
+    smpsNominalPending = 1;
+    return;
+  }
+
+  start = pwr_timestamp_get_ns();
+  configPowerMode(voltMode);
+  elapsed = pwr_timestamp_get_ns() - start;
+  stats->transitions++;
+  stats->settleNs += elapsed;
+  stats->maxNs = elapsed > stats->maxNs ? elapsed : stats->maxNs;
+}
+
+/**
+  * @brief Keep overdrive across the next steps, to run several overdrive inferences in one
+  *        overdrive window. Releasing the hold goes back to nominal if a nominal step was
+  *        requested meanwhile
+  * @param hold 1: keep overdrive, 0: release
+  * @retval None
+  */
+void sysclk_SmpsHoldOverdrive(uint32_t hold)
+{
+  smpsHold = hold;
+  if (!hold && smpsNominalPending)
+  {
+    /* the deferred request is served now */
+    smpsStats[0].avoided--;
+    smpsRequest(SMPS_VOLTAGE_NOMINAL);
+  }
+}
+
+/**
+  * @brief Send the SMPS transitions and settle time over UART, with the NPU profile records,
+  *        then reset them
+  * @retval None
+  */
+void sysclk_SmpsReport(void)
+{
+  static const char *names[] = {"nominal", "overdrive"};
+
+  for (uint32_t i = 0; i < 2; i++)
+  {
+    SysclkSmps *stats = &smpsStats[i];
+
+    printf("[NPU_SOL]smps=%s:transitions=%lu:avoided=%lu:settle_ns=%lu:max_ns=%lu:fixed_ms=%d:power_good=%d[NPU_EOL]\r\n",
+           names[i], stats->transitions, stats->avoided, stats->settleNs, stats->maxNs,
+           SYSCLK_SMPS_SETTLE_MS, SMPS_POWER_GOOD_WAIT);
+    stats->transitions = 0;
+    stats->avoided = 0;
+    stats->settleNs = 0;
+    stats->maxNs = 0;
+  }
 }
 
 /**
@@ -136,7 +331,7 @@ static void npuFrqScaling_switchClocksToPll1(void)
   * @param frequencySteps Pointer to FrequencyStep structure
   * @retval None
   */
-static void npuFrqScaling_configurePlls(FrequencyStep *frequencySteps)
+static void npuFrqScaling_configurePlls(const FrequencyStep *frequencySteps)
 {
   RCC_OscInitTypeDef RCC_OscInitStruct = {0};
   RCC_OscInitStruct.PLL2 = frequencySteps->pll2Cfg;
@@ -165,30 +360,349 @@ static void npuFrqScaling_configurePlls(FrequencyStep *frequencySteps)
   assert(ret == HAL_OK);
 }
 
+#if ((NPU_FRQ_SCALING == 1) && (NPU_FRQ_FAST_SWITCH == 1)) || (CLOCK_MANAGER == 1)
 /**
-  * @brief System clock configuration for NPU frequency scaling
+  * @brief Stop a PLL and start it with a new configuration, same sequence as
+  *        HAL_RCC_OscConfig without the generic checks. The lock is not waited for
+  * @param pll PLL index, 1: PLL2, 2: PLL3
+  * @param pllCfgr1 source, DIVM and DIVN
+  * @param pllCfgr2 DIVNFRAC
+  * @param pllCfgr3 PDIV1 and PDIV2
+  * @retval None
+  */
+static void pllStart(uint32_t pll, uint32_t pllCfgr1, uint32_t pllCfgr2, uint32_t pllCfgr3)
+{
+  __IO uint32_t *cfgr1 = &RCC->PLL1CFGR1 + (4 * pll);
+  __IO uint32_t *cfgr2 = &RCC->PLL1CFGR2 + (4 * pll);
+  __IO uint32_t *cfgr3 = &RCC->PLL1CFGR3 + (4 * pll);
+
+  WRITE_REG(RCC->CCR, RCC_CCR_PLL1ONC << pll);
+  while (READ_BIT(RCC->SR, RCC_SR_PLL1RDY << pll) != 0U);
+
+  SET_BIT(*cfgr3, RCC_PLL1CFGR3_PLL1MODSSDIS);
+  CLEAR_BIT(*cfgr1, RCC_PLL1CFGR1_PLL1BYP);
+  MODIFY_REG(*cfgr1, RCC_PLL1CFGR1_PLL1SEL | RCC_PLL1CFGR1_PLL1DIVM | RCC_PLL1CFGR1_PLL1DIVN, pllCfgr1);
+  MODIFY_REG(*cfgr3, RCC_PLL1CFGR3_PLL1PDIV1 | RCC_PLL1CFGR3_PLL1PDIV2, pllCfgr3);
+  MODIFY_REG(*cfgr2, RCC_PLL1CFGR2_PLL1DIVNFRAC, pllCfgr2);
+  CLEAR_BIT(*cfgr3, RCC_PLL1CFGR3_PLL1MODDSEN);
+  if (pllCfgr2 != 0U)
+  {
+    SET_BIT(*cfgr3, RCC_PLL1CFGR3_PLL1MODDSEN | RCC_PLL1CFGR3_PLL1DACEN);
+  }
+  SET_BIT(*cfgr3, RCC_PLL1CFGR3_PLL1MODSSRST | RCC_PLL1CFGR3_PLL1PDIVEN);
+
+  WRITE_REG(RCC->CSR, RCC_CSR_PLL1ONS << pll);
+}
+#endif
+
+#if (NPU_FRQ_SCALING == 1)
+#if (NPU_FRQ_FAST_SWITCH == 1)
+/**
+  * @brief Check whether a PLL must be relocked to reach the step configuration
+  * @param pll PLL index, 1: PLL2, 2: PLL3
+  * @param regs step register values
+  * @retval 1 if the PLL configuration differs or the PLL is off
+  */
+static uint32_t fastSwitch_pllIsNewConfig(uint32_t pll, const SysclkStep *regs)
+{
+  const __IO uint32_t *cfgr1 = &RCC->PLL1CFGR1 + (4 * pll);
+  const __IO uint32_t *cfgr2 = &RCC->PLL1CFGR2 + (4 * pll);
+  const __IO uint32_t *cfgr3 = &RCC->PLL1CFGR3 + (4 * pll);
+
+  return ((*cfgr1 & (RCC_PLL1CFGR1_PLL1SEL | RCC_PLL1CFGR1_PLL1DIVM | RCC_PLL1CFGR1_PLL1DIVN)) != regs->pllCfgr1[pll - 1])
+      || ((*cfgr2 & RCC_PLL1CFGR2_PLL1DIVNFRAC) != regs->pllCfgr2[pll - 1])
+      || ((*cfgr3 & (RCC_PLL1CFGR3_PLL1PDIV1 | RCC_PLL1CFGR3_PLL1PDIV2)) != regs->pllCfgr3[pll - 1])
+      || (READ_BIT(RCC->SR, RCC_SR_PLL1RDY << pll) == 0U);
+}
+
+/**
+  * @brief Relock a PLL with the step configuration
+  * @param pll PLL index, 1: PLL2, 2: PLL3
+  * @param regs step register values
+  * @retval None
+  */
+static void fastSwitch_pllRelock(uint32_t pll, const SysclkStep *regs)
+{
+  pllStart(pll, regs->pllCfgr1[pll - 1], regs->pllCfgr2[pll - 1], regs->pllCfgr3[pll - 1]);
+  while (READ_BIT(RCC->SR, RCC_SR_PLL1RDY << pll) == 0U);
+}
+
+/**
+  * @brief Move an IC to PLL1 when its source is relocked. Both sources of an IC switch must
+  *        run: an IC fed by a PLL already off is switched once the PLL is relocked
+  * @param icCfgr IC configuration register
+  * @param relock PLLs to relock, bit 0: PLL2, bit 1: PLL3
+  * @param divider PLL1 divider
+  * @retval None
+  */
+static void fastSwitch_parkOnPll1(__IO uint32_t *icCfgr, uint32_t relock, uint32_t divider)
+{
+  uint32_t src = READ_BIT(*icCfgr, RCC_IC1CFGR_IC1SEL);
+  uint32_t pll = (src == RCC_ICCLKSOURCE_PLL2) ? 1U : (src == RCC_ICCLKSOURCE_PLL3) ? 2U : 0U;
+
+  if ((pll != 0U) && (relock & (1U << (pll - 1U))) && (READ_BIT(RCC->SR, RCC_SR_PLL1RDY << pll) != 0U))
+  {
+    WRITE_REG(*icCfgr, RCC_ICCLKSOURCE_PLL1 | ((divider - 1U) << RCC_IC1CFGR_IC1INT_Pos));
+  }
+}
+
+/**
+  * @brief Switch to a step with its precomputed register values: PLLs already at the
+  *        step frequency are not relocked, ICs are only parked on PLL1 when their PLL is
+  *        relocked and VddCore is only changed when the step needs another voltage
+  * @param regs step register values
+  * @retval None
+  */
+static void fastSwitch(const SysclkStep *regs)
+{
+  uint32_t relock = fastSwitch_pllIsNewConfig(1, regs) | (fastSwitch_pllIsNewConfig(2, regs) << 1);
+
+  if (relock)
+  {
+    fastSwitch_parkOnPll1(&RCC->IC1CFGR, relock, SYSCLK_PARK_CPU_DIV);
+    fastSwitch_parkOnPll1(&RCC->IC6CFGR, relock, SYSCLK_PARK_NPU_DIV);
+    fastSwitch_parkOnPll1(&RCC->IC11CFGR, relock, SYSCLK_PARK_NPU_DIV);
+  }
+
+  /* if overdrive, increase VddCore before switching to freq max */
+  if (regs->step->overdrive)
+  {
+    smpsRequest(SMPS_VOLTAGE_OVERDRIVE);
+  }
+
+  if (relock & 1U)
+  {
+    fastSwitch_pllRelock(1, regs);
+  }
+  if (relock & 2U)
+  {
+    fastSwitch_pllRelock(2, regs);
+  }
+
+  WRITE_REG(RCC->IC1CFGR, regs->icCfgr[0]);
+  WRITE_REG(RCC->IC6CFGR, regs->icCfgr[1]);
+  WRITE_REG(RCC->IC11CFGR, regs->icCfgr[2]);
+  WRITE_REG(RCC->DIVENSR, RCC_DIVENSR_IC1ENS | RCC_DIVENSR_IC6ENS | RCC_DIVENSR_IC11ENS);
+
+  if (LL_RCC_GetCpuClkSource() != RCC_CPUCLKSOURCE_STATUS_IC1)
+  {
+    MODIFY_REG(RCC->CFGR1, RCC_CFGR1_CPUSW, RCC_CPUCLKSOURCE_IC1);
+    while (LL_RCC_GetCpuClkSource() != RCC_CPUCLKSOURCE_STATUS_IC1);
+  }
+  if (LL_RCC_GetSysClkSource() != RCC_SYSCLKSOURCE_STATUS_IC2_IC6_IC11)
+  {
+    MODIFY_REG(RCC->CFGR1, RCC_CFGR1_SYSSW, RCC_SYSCLKSOURCE_IC2_IC6_IC11);
+    while (LL_RCC_GetSysClkSource() != RCC_SYSCLKSOURCE_STATUS_IC2_IC6_IC11);
+  }
+  SystemCoreClock = HAL_RCC_GetCpuClockFreq();
+
+  /* if nominal mode, decrease VddCore only after switching to nominal mode frequencies */
+  if (!regs->step->overdrive)
+  {
+    smpsRequest(SMPS_VOLTAGE_NOMINAL);
+  }
+}
+#endif /* NPU_FRQ_FAST_SWITCH */
+
+/**
+  * @brief Find a frequency step prepared by sysclk_NpuFreqScalingPrepare
+  * @param frequencySteps Pointer to FrequencyStep structure
+  * @retval step register values and switch latency, NULL if not prepared
+  */
+static SysclkStep *npuFrqScaling_findStep(const FrequencyStep *frequencySteps)
+{
+  for (uint32_t i = 0; i < sysclkNbSteps; i++)
+  {
+    if (sysclkSteps[i].step == frequencySteps)
+    {
+      return &sysclkSteps[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief Build once the register values of a frequency step
+  * @param frequencySteps Pointer to FrequencyStep structure, kept until the end of the application
+  * @retval None
+  */
+void sysclk_NpuFreqScalingPrepare(const FrequencyStep *frequencySteps)
+{
+  SysclkStep *regs;
+
+  if (npuFrqScaling_findStep(frequencySteps) != NULL)
+  {
+    return;
+  }
+  assert(sysclkNbSteps < SYSCLK_MAX_STEPS);
+  regs = &sysclkSteps[sysclkNbSteps++];
+  regs->step = frequencySteps;
+#if (NPU_FRQ_FAST_SWITCH == 1)
+  const RCC_PLLInitTypeDef *pll[2] = {&frequencySteps->pll2Cfg, &frequencySteps->pll3Cfg};
+
+  for (int i = 0; i < 2; i++)
+  {
+    assert(pll[i]->PLLState == RCC_PLL_ON);
+    regs->pllCfgr1[i] = pll[i]->PLLSource | (pll[i]->PLLM << RCC_PLL1CFGR1_PLL1DIVM_Pos)
+                      | (pll[i]->PLLN << RCC_PLL1CFGR1_PLL1DIVN_Pos);
+    regs->pllCfgr2[i] = pll[i]->PLLFractional << RCC_PLL1CFGR2_PLL1DIVNFRAC_Pos;
+    regs->pllCfgr3[i] = (pll[i]->PLLP1 << RCC_PLL1CFGR3_PLL1PDIV1_Pos) | (pll[i]->PLLP2 << RCC_PLL1CFGR3_PLL1PDIV2_Pos);
+  }
+  /* dividers by 1, as configured by npuFrqScaling_configurePlls */
+  regs->icCfgr[0] = frequencySteps->cpuClkSrc;
+  regs->icCfgr[1] = frequencySteps->npuClkSrc;
+  regs->icCfgr[2] = frequencySteps->npuRamsClkSrc;
+#endif
+}
+
+/**
+  * @brief Send the switch latency of each frequency step over UART, with the NPU profile
+  *        records, then reset it
+  * @retval None
+  */
+void sysclk_NpuFreqScalingReport(void)
+{
+  for (uint32_t i = 0; i < sysclkNbSteps; i++)
+  {
+    SysclkStep *regs = &sysclkSteps[i];
+
+    if (regs->switches == 0)
+    {
+      continue;
+    }
+    printf("[NPU_SOL]clock_step=%s:switches=%lu:switch_ns=%lu:max_ns=%lu:fast=%d[NPU_EOL]\r\n",
+           regs->step->stepName, regs->switches, regs->ns, regs->maxNs, NPU_FRQ_FAST_SWITCH);
+    regs->switches = 0;
+    regs->ns = 0;
+    regs->maxNs = 0;
+  }
+}
+#endif /* NPU_FRQ_SCALING */
+
+/**
+  * @brief System clock configuration for NPU frequency scaling, through HAL_RCC_OscConfig
+  *        and HAL_RCC_ClockConfig
   * @param frequencySteps Pointer to FrequencyStep structure
   * @retval None
   */
-void sysclk_NpuFreqScaling(FrequencyStep *frequencySteps)
+static void npuFrqScaling_halSwitch(const FrequencyStep *frequencySteps)
 {
   /* switch CPU, NPU, NPURams clock source to PLL1 before modifying it */
   npuFrqScaling_switchClocksToPll1();
 
   /* if overdrive, increase VddCore before switching to freq max */
-  if(frequencySteps->npufreq == 1000)
+  if(frequencySteps->overdrive)
   {
-    configPowerMode(SMPS_VOLTAGE_OVERDRIVE);
+    smpsRequest(SMPS_VOLTAGE_OVERDRIVE);
   }
 
   /* configure CPU and NPU and NPURams plls according to step config*/
   npuFrqScaling_configurePlls(frequencySteps);
 
   /* if nominal mode, decrease VddCore only after switching to nominal mode frequencies */
-  if(frequencySteps->npufreq < 1000)
+  if(!frequencySteps->overdrive)
+  {
+    smpsRequest(SMPS_VOLTAGE_NOMINAL);
+  }
+#if (PWR_TIMESTAMP_HIGHRES == 1)
+  pwr_timestamp_cpu_clock_changed();
+#endif
+}
+
+/**
+  * @brief System clock configuration for NPU frequency scaling
+  * @param frequencySteps Pointer to FrequencyStep structure
+  * @retval None
+  */
+void sysclk_NpuFreqScaling(const FrequencyStep *frequencySteps)
+{
+#if (NPU_FRQ_SCALING == 1)
+  SysclkStep *regs = npuFrqScaling_findStep(frequencySteps);
+  uint32_t start = pwr_timestamp_get_ns();
+  uint32_t elapsed;
+
+#if (NPU_FRQ_FAST_SWITCH == 1)
+  if (regs != NULL)
+  {
+    fastSwitch(regs);
+#if (PWR_TIMESTAMP_HIGHRES == 1)
+    pwr_timestamp_cpu_clock_changed();
+#endif
+  }
+  else
+  {
+    /* step not prepared, no register values */
+    npuFrqScaling_halSwitch(frequencySteps);
+  }
+#else
+  npuFrqScaling_halSwitch(frequencySteps);
+#endif
+
+  if (regs != NULL)
+  {
+    elapsed = pwr_timestamp_get_ns() - start;
+    regs->switches++;
+    regs->ns += elapsed;
+    regs->maxNs = elapsed > regs->maxNs ? elapsed : regs->maxNs;
+  }
+#else
+  npuFrqScaling_halSwitch(frequencySteps);
+#endif
+}
+
+/**
+  * @brief Change the NPU and NPU RAMs clock dividers, their sources are unchanged
+  * @param npuDiv NPU clock (IC6) divider
+  * @param ramsDiv NPU RAMs clock (IC11) divider
+  * @retval None
+  * @note no PLL relock and no VddCore change, it can be used between two epoch blocks
+  */
+void sysclk_NpuSetClockDividers(uint32_t npuDiv, uint32_t ramsDiv)
+{
+  LL_RCC_IC6_SetDivider(npuDiv);
+  LL_RCC_IC11_SetDivider(ramsDiv);
+}
+
+/**
+  * @brief Get the NPU and NPU RAMs clock dividers
+  * @param npuDiv NPU clock (IC6) divider
+  * @param ramsDiv NPU RAMs clock (IC11) divider
+  * @retval None
+  */
+void sysclk_NpuGetClockDividers(uint32_t *npuDiv, uint32_t *ramsDiv)
+{
+  *npuDiv = LL_RCC_IC6_GetDivider();
+  *ramsDiv = LL_RCC_IC11_GetDivider();
+}
+
+/**
+  * @brief NPU clock frequency, from the IC6 source and divider
+  * @retval frequency in Hz
+  */
+uint32_t sysclk_GetNpuClockFreq(void)
+{
+  uint32_t src = LL_RCC_IC6_GetSource();
+  uint32_t freq;
+
+  if (src == RCC_ICCLKSOURCE_PLL1)
+  {
+    freq = HAL_RCCEx_GetPLL1CLKFreq();
+  }
+  else if (src == RCC_ICCLKSOURCE_PLL2)
+  {
+    freq = HAL_RCCEx_GetPLL2CLKFreq();
+  }
+  else if (src == RCC_ICCLKSOURCE_PLL3)
   {
-    configPowerMode(SMPS_VOLTAGE_NOMINAL);
+    freq = HAL_RCCEx_GetPLL3CLKFreq();
   }
+  else
+  {
+    freq = HAL_RCCEx_GetPLL4CLKFreq();
+  }
+
+  return freq / LL_RCC_IC6_GetDivider();
 }
 
 /**
@@ -292,6 +806,169 @@ void sysclk_NpuRamsOverDriveClockDeinit(RCC_ClkInitTypeDef *pRCC_ClkInitStruct)
   assert(ret == HAL_OK);
 }
 
+#if (CLOCK_MANAGER == 1)
+/**
+  * @brief Start the PLL of a clock if it is off, without waiting for its lock
+  * @param pll managed PLL
+  * @retval None
+  */
+static void clockMgr_pllOn(SysclkPll *pll)
+{
+  if (pll->on)
+  {
+    return;
+  }
+  pll->onStart = pwr_timestamp_get();
+  pll->lockStart = pwr_timestamp_get_ns();
+  pllStart(pll->pll, pll->cfgr1, 0, pll->cfgr3);
+  pll->on = 1;
+}
+
+/**
+  * @brief Wait for the lock of a started PLL. The lock time is only known when the lock
+  *        is waited for, a lock hidden by the work done since the start is counted without
+  * @param pll managed PLL
+  * @retval None
+  */
+static void clockMgr_pllWaitLock(SysclkPll *pll)
+{
+  uint32_t start = pwr_timestamp_get_ns();
+  uint32_t end;
+
+  if (READ_BIT(RCC->SR, RCC_SR_PLL1RDY << pll->pll) == 0U)
+  {
+    while (READ_BIT(RCC->SR, RCC_SR_PLL1RDY << pll->pll) == 0U);
+    end = pwr_timestamp_get_ns();
+    pll->waitNs += end - start;
+    pll->lockNs += end - pll->lockStart;
+  }
+  pll->locks++;
+}
+
+/**
+  * @brief Power down a PLL, its clocks are parked on PLL1
+  * @param pll managed PLL
+  * @retval None
+  */
+static void clockMgr_pllOff(SysclkPll *pll)
+{
+  WRITE_REG(RCC->CCR, RCC_CCR_PLL1ONC << pll->pll);
+  pll->onUs += pwr_timestamp_get() - pll->onStart;
+  pll->on = 0;
+}
+
+/**
+  * @brief Start the PLLs of clocks required soon, so that they lock while the CPU does
+  *        something else (external memories init). The clocks are switched by
+  *        sysclk_ClockRequire, which must follow
+  * @param clocks SYSCLK_CLOCK_xxx mask
+  * @retval None
+  */
+void sysclk_ClockPreLock(uint32_t clocks)
+{
+  for (uint32_t i = 0; i < sizeof(sysclkClocks) / sizeof(sysclkClocks[0]); i++)
+  {
+    if (clocks & (1U << i))
+    {
+      clockMgr_pllOn(sysclkClocks[i].pll);
+    }
+  }
+}
+
+/**
+  * @brief Take a reference on clocks. The first reference of a clock powers its PLL if
+  *        needed, waits for the lock and switches the IC divider to the PLL
+  * @param clocks SYSCLK_CLOCK_xxx mask
+  * @retval None
+  */
+void sysclk_ClockRequire(uint32_t clocks)
+{
+  for (uint32_t i = 0; i < sizeof(sysclkClocks) / sizeof(sysclkClocks[0]); i++)
+  {
+    SysclkClock *clock = &sysclkClocks[i];
+
+    if (!(clocks & (1U << i)) || (clock->refs++ != 0))
+    {
+      continue;
+    }
+    if (clock->pll->refs++ == 0)
+    {
+      clockMgr_pllOn(clock->pll);
+      clockMgr_pllWaitLock(clock->pll);
+    }
+    /* divider by 1 */
+    WRITE_REG(*clock->icCfgr, clock->icSource);
+  }
+}
+
+/**
+  * @brief Drop a reference on clocks. The last reference of a clock parks its IC divider
+  *        on PLL1, the last clock of a PLL powers it down
+  * @param clocks SYSCLK_CLOCK_xxx mask
+  * @retval None
+  */
+void sysclk_ClockRelease(uint32_t clocks)
+{
+  for (uint32_t i = 0; i < sizeof(sysclkClocks) / sizeof(sysclkClocks[0]); i++)
+  {
+    SysclkClock *clock = &sysclkClocks[i];
+
+    if (!(clocks & (1U << i)))
+    {
+      continue;
+    }
+    assert(clock->refs != 0);
+    if (--clock->refs != 0)
+    {
+      continue;
+    }
+    WRITE_REG(*clock->icCfgr, RCC_ICCLKSOURCE_PLL1 | ((SYSCLK_PARK_DIV - 1U) << RCC_IC1CFGR_IC1INT_Pos));
+    if (--clock->pll->refs == 0)
+    {
+      clockMgr_pllOff(clock->pll);
+    }
+  }
+}
+
+/**
+  * @brief Start the on-time of the PLLs still on at the start of a sequence, to be called
+  *        once the timestamps are started
+  * @retval None
+  */
+void sysclk_ClockStart(void)
+{
+  for (uint32_t i = 0; i < sizeof(sysclkPlls) / sizeof(sysclkPlls[0]); i++)
+  {
+    sysclkPlls[i].onStart = pwr_timestamp_get();
+  }
+}
+
+/**
+  * @brief Send the lock time and the on-time of the managed PLLs over UART, with the NPU
+  *        profile records, then reset them. The on-time of a PLL still on is counted up to
+  *        now, sysclk_ClockStart starts it again with the next sequence
+  * @retval None
+  */
+void sysclk_ClockReport(void)
+{
+  for (uint32_t i = 0; i < sizeof(sysclkPlls) / sizeof(sysclkPlls[0]); i++)
+  {
+    SysclkPll *pll = &sysclkPlls[i];
+
+    if (pll->on)
+    {
+      pll->onUs += pwr_timestamp_get() - pll->onStart;
+    }
+    printf("[NPU_SOL]pll=%s:locks=%lu:lock_ns=%lu:wait_ns=%lu:on_us=%lu[NPU_EOL]\r\n",
+           pll->name, pll->locks, pll->lockNs, pll->waitNs, pll->onUs);
+    pll->locks = 0;
+    pll->lockNs = 0;
+    pll->waitNs = 0;
+    pll->onUs = 0;
+  }
+}
+#endif /* CLOCK_MANAGER */
+
 /**
   * @brief Enable NPU clock and reset IP
   * @retval None
@@ -301,8 +978,10 @@ void sysclk_NpuClockEnable(void)
   __HAL_RCC_NPU_CLK_ENABLE();
   __HAL_RCC_NPU_CLK_SLEEP_ENABLE();
 
+#if (NN_PERSISTENT_RUNTIME == 0)
   __HAL_RCC_NPU_FORCE_RESET();
   __HAL_RCC_NPU_RELEASE_RESET();
+#endif /* NN_PERSISTENT_RUNTIME: runtime initialized once, NPU must keep its state */
 }
 
 /**
@@ -323,12 +1002,12 @@ void sysclk_NpuClockConfig(void)
 {
  /* configure PLL for NPU and NPURams for overdrive mode
   * in case of nominal mode, the NPU and NPURams will use the PLL1 already configured */
-#if(POWER_OVERDRIVE == 1)
+#if(POWER_OVERDRIVE == 1) && (CLOCK_MANAGER == 0)
   RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
   HAL_RCC_GetClockConfig(&RCC_ClkInitStruct);
   sysclk_NpuOverDriveClockConfig(&RCC_ClkInitStruct);
   sysclk_NpuRamsOverDriveClockConfig(&RCC_ClkInitStruct);
-#endif /*POWER_OVERDRIVE*/
+#endif /* POWER_OVERDRIVE, clocks required by the stages with CLOCK_MANAGER */
 }
 
 /**
@@ -382,6 +1061,9 @@ void sysclk_SetCpuMaxFreq(void)
 
   ret = HAL_RCC_ClockConfig(&RCC_ClkInitStruct);
   assert(ret == HAL_OK);
+#if (PWR_TIMESTAMP_HIGHRES == 1)
+  pwr_timestamp_cpu_clock_changed();
+#endif
 #endif /* CPU_FRQ_SCALE_DOWN */
 }
 
@@ -400,6 +1082,9 @@ void sysclk_SetCpuMinFreq(void)
 
   ret = HAL_RCC_ClockConfig(&RCC_ClkInitStruct);
   assert(ret == HAL_OK);
+#if (PWR_TIMESTAMP_HIGHRES == 1)
+  pwr_timestamp_cpu_clock_changed();
+#endif
 #endif /* CPU_FRQ_SCALE_DOWN */
 }
 
@@ -412,9 +1097,6 @@ static void sysclk_SystemClockConfig_Overdrive(void)
 {
   int ret;
 
-  /* configure external SMPS to deliver overdrive power 0.89vols */
-  configPowerMode(SMPS_VOLTAGE_OVERDRIVE);
-
   RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
   RCC_OscInitTypeDef RCC_OscInitStruct = {0};
   RCC_PeriphCLKInitTypeDef RCC_PeriphCLKInitStruct = {0};
@@ -606,11 +1288,28 @@ static void sysclk_SystemClockConfig_Nominal(void)
   */
 void sysclk_SystemClockConfig(void)
 {
+#if(POWER_OVERDRIVE == 1)
+  /* configure external SMPS to deliver overdrive power 0.89vols */
+  configPowerMode(SMPS_VOLTAGE_OVERDRIVE);
+#endif
+  sysclk_SystemClockRestore();
+}
+
+/**
+  * @brief Restore the system clock tree after STOP mode (clocks back on HSI, HSE and PLLs off).
+  *        External SMPS voltage is kept during STOP mode, only the clocks are configured again.
+  * @retval None
+  */
+void sysclk_SystemClockRestore(void)
+{
 #if(POWER_OVERDRIVE == 1)
   sysclk_SystemClockConfig_Overdrive();
 #else
   sysclk_SystemClockConfig_Nominal();
 #endif
+#if (PWR_TIMESTAMP_HIGHRES == 1)
+  pwr_timestamp_cpu_clock_changed();
+#endif
 }
 
 /**
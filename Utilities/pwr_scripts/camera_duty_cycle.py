@@ -0,0 +1,148 @@
+# /*---------------------------------------------------------------------------------------------
+#  * Copyright (c) 2024 STMicroelectronics.
+#  * All rights reserved.
+#  *
+#  * This software is licensed under terms that can be found in the LICENSE file in
+#  * the root directory of this software component.
+#  * If no LICENSE file comes with this software, it is provided AS-IS.
+#  *--------------------------------------------------------------------------------------------*/
+
+
+import argparse
+import csv
+from statistics import mean
+
+from full_sequence_power import filter_sequence_samples, get_available_power_name, get_power_per_state, get_total_energy
+
+# camera steps logged by the application: CAMERA_WARM_MODE=0 build (CAM_Init/CAM_DeInit at each
+# trigger) for the cold sequence, CAMERA_WARM_MODE=1 build (sensor resume/standby) for the warm one
+COLD_STEPS = ["CAM init", "camera de-init"]
+WARM_STEPS = ["CAM warm resume", "camera standby"]
+CAMERA_STEPS = [
+"CAM init",
+"camera de-init",
+"CAM warm resume",
+"camera standby"
+]
+
+FPS_LIST = [1, 2, 5, 10, 15, 20, 30]
+
+def get_idle_power(rows):
+  """
+  Power between two triggers: samples after the end of the sequence (PA3 falling edge), or
+  after its last step when PA3 is not captured, up to the next sequence. The camera is off
+  after a cold sequence and in standby after a warm one.
+  """
+  idle = []
+  if 'PA3' in rows[0]:
+    ended = False
+    prev = 0
+    for r in rows:
+      value = float(r['PA3'])
+      if value == 0 and prev == 1:
+        ended = True
+      elif value == 1 and prev == 0 and ended:
+        break
+      if ended:
+        idle.append(r)
+      prev = value
+  else:
+    started = False
+    for r in rows:
+      if r['seq_name'] != 'NOT_FOUND':
+        started = True
+      elif started:
+        idle.append(r)
+  if not idle:
+    return None
+
+  return sum([mean([float(r[name]) for r in idle]) for name in get_available_power_name(idle)])
+
+def get_sequence(csv_filename):
+  with open(csv_filename, newline='') as f:
+    reader = csv.DictReader(f)
+    all_rows = list(reader)
+    rows = filter_sequence_samples(all_rows)
+    res = get_power_per_state(rows)
+
+  energy = 0
+  duration = 0
+  cam_energy = 0
+  cam_duration = 0
+  for data in res:
+    e = get_total_energy(data['datas'])
+    d = data['datas'][0][3]
+    energy += e
+    duration += d
+    if data['seq_name'] in CAMERA_STEPS:
+      cam_energy += e
+      cam_duration += d
+
+  return {'energy': energy, 'duration': duration, 'cam_energy': cam_energy, 'cam_duration': cam_duration,
+          'idle_power': get_idle_power(all_rows), 'steps': set(data['seq_name'] for data in res)}
+
+def check_sequence(name, seq, expected_steps, build):
+  """
+  The camera steps of the capture must come from the expected build: a cold sequence of a
+  CAMERA_WARM_MODE=1 build puts the sensor in standby, it has neither the CAM_DeInit energy
+  nor the camera off power between frames.
+  """
+  missing = [step for step in expected_steps if step not in seq['steps']]
+  if missing:
+    print(f"{name} capture has no {', '.join(missing)} step, capture it with a {build} build")
+    return False
+  return True
+
+def get_average_power(seq, idle_power, fps):
+  period = 1.0 / fps
+  if seq['duration'] > period:
+    return None
+  return (seq['energy'] + idle_power * (period - seq['duration'])) / period
+
+def display_sequence(name, seq):
+  print(f"{name:5s}: {seq['energy'] * 1000000:10.1f} uJ in {seq['duration'] * 1000:8.2f} ms per frame"
+        f" (camera init/de-init steps: {seq['cam_energy'] * 1000000:10.1f} uJ in {seq['cam_duration'] * 1000:8.2f} ms)")
+
+def main(args):
+  cold = get_sequence(args.cold_csv)
+  warm = get_sequence(args.warm_csv)
+  if not check_sequence("cold", cold, COLD_STEPS, "CAMERA_WARM_MODE=0") or \
+     not check_sequence("warm", warm, WARM_STEPS, "CAMERA_WARM_MODE=1"):
+    return
+  # power between frames measured on each capture, unless given on the command line
+  idle_power = args.idle_mw / 1000 if args.idle_mw is not None else cold['idle_power']
+  standby_power = args.standby_mw / 1000 if args.standby_mw is not None else warm['idle_power']
+  if idle_power is None or standby_power is None:
+    print("no sample between two triggers in the captures, give the power between frames with -i and -s")
+    return
+
+  print("--------------------------------------------------------------------------------------------")
+  display_sequence("cold", cold)
+  display_sequence("warm", warm)
+  print("--------------------------------------------------------------------------------------------")
+  print(f"idle power between frames: cold {idle_power * 1000:.2f} mW, warm {standby_power * 1000:.2f} mW")
+  print("  fps |   cold avg mW |   warm avg mW | best")
+  for fps in FPS_LIST:
+    p_cold = get_average_power(cold, idle_power, fps)
+    p_warm = get_average_power(warm, standby_power, fps)
+    cells = [f"{p * 1000:13.2f}" if p is not None else f"{'n/a':>13s}" for p in (p_cold, p_warm)]
+    if p_cold is None and p_warm is None:
+      best = "none"
+    elif p_warm is None or (p_cold is not None and p_cold <= p_warm):
+      best = "cold"
+    else:
+      best = "warm"
+    print(f" {fps:4d} | {cells[0]} | {cells[1]} | {best}")
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+
+    parser.add_argument('cold_csv', help='capture of a cold start sequence, CAMERA_WARM_MODE=0 build (CAM_Init/CAM_DeInit)')
+    parser.add_argument('warm_csv', help='capture of a warm resume sequence, CAMERA_WARM_MODE=1 build (sensor resume/standby)')
+    parser.add_argument('-i', '--idle_mw', type=float, default=None, help='power between frames with camera off (mW), default measured after the cold sequence of the CAMERA_WARM_MODE=0 build')
+    parser.add_argument('-s', '--standby_mw', type=float, default=None, help='power between frames with sensor in standby (mW), default measured after the warm sequence')
+
+    args = parser.parse_args()
+    return args
+if __name__ == '__main__':
+  main(parse_args())
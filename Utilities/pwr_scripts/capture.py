@@ -23,7 +23,7 @@ import matplotlib.pyplot as plt
 from matplotlib.lines import Line2D
 
 from toolbox import StlinkPwrCaptureConfig, StlinkPwrCapture
-from toolbox import StlinkComPortConfig, StlinkComPort
+from toolbox import StlinkComPortConfig, StlinkComPort, npu_profile_filename
 
 POWER_COLORS = {
     'VDDCORE': '#00B050',
@@ -98,7 +98,8 @@ def apply_stlink_com_ctrl(device, freq, duration):
                         'RCC_APB1HENR', 'RCC_APB2ENR', 'RCC_APB3ENR', 
                         'RCC_APB4LENR', 'RCC_APB4HENR', 'RCC_APB5ENR' ]
 
-    dev = StlinkComPort(config, StlinkComPortField , get_stlink_com_by_serial(device['serial']), device['baud_rate'])
+    dev = StlinkComPort(config, StlinkComPortField , get_stlink_com_by_serial(device['serial']), device['baud_rate'],
+                        binary=device.get('binary', False))
 
     return dev
 
@@ -258,6 +259,17 @@ def capture(args):
             writer = csv.writer(csvfile)
             writer.writerow(names)
             writer.writerows(rows)
+        # NPU profile records, written next to the capture
+        profile = []
+        for device in devices:
+            if hasattr(device, 'get_npu_profile'):
+                profile += device.get_npu_profile()
+        if profile:
+            fields = list(dict.fromkeys(k for record in profile for k in record))
+            with open(npu_profile_filename(args.write_csv), 'w', newline='') as csvfile:
+                writer = csv.DictWriter(csvfile, fieldnames=fields)
+                writer.writeheader()
+                writer.writerows(profile)
     else:
         assert(0) # data to be written to a csv file
 
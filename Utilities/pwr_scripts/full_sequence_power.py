@@ -10,6 +10,8 @@
 
 import argparse
 import csv
+import os
+import re
 import sys
 from statistics import mean
 
@@ -179,7 +181,7 @@ def get_power_for_state(rows, seq_idx):
 
 def get_power_per_state(rows):
   res = []
-  for i in range(100):
+  for i in sorted({int(r['seq_idx']) for r in rows}):
     rows_state = filter_sequence_samples_per_state(rows, i)
     row_res = get_power_for_state(rows_state, i)
     if row_res:
@@ -289,6 +291,337 @@ def display_cooked(datas, is_verbose, is_clocked):
     for info in verbose_info:
       print("   %-9s %8.1f uJ" % (info[0], info[1] * 1000000))
 
+# step names logged by the firmware with NN_EPOCH_TRACE
+EPOCH_STEP = re.compile(r'^(?:(?P<net>\S+) )?eb(?P<eb>\d+) (?P<event>start|end) (?P<kind>hw|sw|hyb)'
+                        r'(?: e(?P<first>-?\d+)-(?P<last>-?\d+))?$')
+
+def get_epoch_energy(datas):
+  """
+  A step ends at the timestamp giving its name: the step ending at "eb<n> end" is the
+  epoch block n, the step ending at "eb<n> start" after another block is runtime
+  overhead between blocks. Inferences run several times are accumulated.
+  """
+  blocks = {}
+  overhead = {}
+  prev_in_epoch = False
+  for data in datas:
+    m = EPOCH_STEP.match(data['seq_name'])
+    if not m:
+      prev_in_epoch = False
+      continue
+    net = m.group('net') or 'Default'
+    energy = get_total_energy(data['datas'])
+    elapsed = data['datas'][0][3]
+    if m.group('event') == 'start':
+      if prev_in_epoch:
+        o = overhead.setdefault(net, [0, 0])
+        o[0] += energy
+        o[1] += elapsed
+    else:
+      b = blocks.setdefault((net, int(m.group('eb'))), {
+        'kind': m.group('kind'),
+        'epochs': f"{m.group('first')}-{m.group('last')}" if m.group('first') else '',
+        'energy': 0, 'time': 0, 'runs': 0})
+      b['energy'] += energy
+      b['time'] += elapsed
+      b['runs'] += 1
+    prev_in_epoch = True
+
+  return blocks, overhead
+
+# busiest stream engine active ratio above which an epoch block is reported stream bound
+STREAM_BOUND_RATIO = 0.8
+
+# NPU profile record types, named after the first key of the record
+NPU_RECORD_TYPES = ('network', 'clock_step', 'pll', 'smps', 'cache_check')
+
+def read_npu_records(csv_filename):
+  """
+  NPU profile records written by capture.py next to the capture, read once and grouped by
+  record type. Each record only keeps its own fields.
+  """
+  records = {t: [] for t in NPU_RECORD_TYPES}
+  filename = os.path.splitext(csv_filename)[0] + '_npu.csv'
+  if not os.path.exists(filename):
+    return records
+  with open(filename, newline='') as f:
+    for r in csv.DictReader(f):
+      for t in NPU_RECORD_TYPES:
+        if r.get(t):
+          records[t].append({k: v for k, v in r.items() if v})
+          break
+  return records
+
+def read_npu_profile(records):
+  """Epoch block records (NPU_PROFILE, NN_EPOCH_FREQ_PLAN, CPU_FRQ_SCALE_DOWN_ADAPTIVE)."""
+  profile = {}
+  for r in records['network']:
+    # profile, frequency plan and wfe records of a block are merged
+    profile.setdefault((r['network'], int(r['eb'])), {}).update(r)
+  return profile
+
+def read_clock_switches(records):
+  """Clock switch latency of the NPU_FRQ_SCALING steps."""
+  return {r['clock_step']: r for r in records['clock_step']}
+
+def display_clock_switches(switches):
+  if not switches:
+    return
+  print("--------------------------------------------------------------------------------------------")
+  print("clock step               :   switches  mean latency   max latency")
+  for name, r in switches.items():
+    n = int(r['switches'])
+    print(f"{name:24s} : {n:10d} {int(r['switch_ns']) / n / 1000 if n else 0:10.1f} us"
+          f" {int(r['max_ns']) / 1000:10.1f} us{'  (fast switch)' if r.get('fast') == '1' else ''}")
+
+def read_plls(records):
+  """Lock time and on-time of the PLLs of the clock manager (CLOCK_MANAGER)."""
+  plls = {}
+  for r in records['pll']:
+    pll = plls.setdefault(r['pll'], dict.fromkeys(('locks', 'lock_ns', 'wait_ns', 'on_us'), 0))
+    for k in pll:
+      pll[k] += int(r[k])
+  return plls
+
+def display_plls(plls, full_sequence_time):
+  if not plls:
+    return
+  print("--------------------------------------------------------------------------------------------")
+  print("pll  :  locks  lock time (waited)  lock wait      on-time")
+  for name, p in sorted(plls.items()):
+    print(f"{name:4s} : {p['locks']:6d} {p['lock_ns'] / 1000:15.1f} us {p['wait_ns'] / 1000:10.1f} us"
+          f" {p['on_us'] / 1000:9.3f} ms ({p['on_us'] / 1e6 * 100 / full_sequence_time:5.1f} % of the sequence)")
+
+def read_smps(records):
+  """SMPS transitions per output (NPU_FRQ_SCALING)."""
+  smps = {}
+  for r in records['smps']:
+    s = smps.setdefault(r['smps'], {'transitions': 0, 'avoided': 0, 'settle_ns': 0, 'max_ns': 0})
+    for k in ('transitions', 'avoided', 'settle_ns'):
+      s[k] += int(r[k])
+    s['max_ns'] = max(s['max_ns'], int(r['max_ns']))
+    s['fixed_ms'] = int(r['fixed_ms'])
+    s['power_good'] = r['power_good'] == '1'
+  return smps
+
+def display_smps(smps, datas):
+  """
+  SMPS transitions and energy saved against a transition with the fixed delay for each
+  request: avoided transitions and shorter power-good waits. The power during a transition
+  is the mean power of the "config npu clock scaling" steps, where the transitions are done.
+  """
+  if not smps:
+    return
+  config = [d for d in datas if d['seq_name'] == 'config npu clock scaling']
+  config_time = sum(d['datas'][0][3] for d in config)
+  power = sum(get_total_energy(d['datas']) for d in config) / config_time if config_time else 0
+  print("--------------------------------------------------------------------------------------------")
+  print("smps output :  transitions  avoided  mean settle    max settle   saved time")
+  saved_s = 0
+  for name, s in sorted(smps.items()):
+    n = s['transitions']
+    saved = (s['avoided'] + n) * s['fixed_ms'] / 1000 - s['settle_ns'] / 1e9
+    saved_s += saved
+    print(f"{name:11s} : {n:12d} {s['avoided']:8d} {s['settle_ns'] / n / 1000 if n else 0:10.1f} us"
+          f" {s['max_ns'] / 1000:10.1f} us {saved * 1000:9.1f} ms{'  (power-good wait)' if s['power_good'] else ''}")
+  print(f"smps transitions : {saved_s * 1000:.1f} ms saved, {saved_s * power * 1000000:.1f} uJ at {power * 1000:.2f} mW")
+
+def display_npu_profile(profile, blocks):
+  """
+  Transfers profile: bandwidth per NPU bus interface over the epoch block.
+  Stalls profile: NPU clock and stream engines activity, a block whose busiest stream engine
+  is active most of the time is limited by the data streams (memory), otherwise by the
+  processing units (compute).
+  """
+  print("--------------------------------------------------------------------------------------------")
+  for (net, eb), p in sorted(profile.items()):
+    if 'ns' not in p:
+      continue
+    ns = int(p['ns'])
+    energy = blocks[(net, eb)]['energy'] * 1000000 if (net, eb) in blocks else None
+    line = f"{net:12s} eb{eb:<3d} {p['kind']:4s} {ns / 1000:10.1f} us"
+    if 'rd0' in p:
+      rd = int(p['rd0']) + int(p['rd1'])
+      wr = int(p['wr0']) + int(p['wr1'])
+      line += f" : read {rd:9d} B ({rd * 1000 / ns if ns else 0:8.1f} MB/s)"
+      line += f" write {wr:9d} B ({wr * 1000 / ns if ns else 0:8.1f} MB/s)"
+      if energy is not None and rd + wr:
+        line += f" {energy * 1000000 / (rd + wr):8.2f} pJ/B"
+    if 'cycles' in p:
+      cycles = int(p['cycles'])
+      engines = int(p['engines'])
+      busiest = int(p['active_max']) / cycles if cycles else 0
+      average = int(p['active_sum']) / (cycles * engines) if cycles and engines else 0
+      line += f" : {cycles:9d} NPU cycles ({cycles * 1000 / ns if ns else 0:6.1f} MHz)"
+      line += f" stream engines active {busiest * 100:5.1f} % busiest, {average * 100:5.1f} % average"
+      if engines:
+        line += " memory bound" if busiest >= STREAM_BOUND_RATIO else " compute bound"
+    print(line)
+
+def display_freq_plan(profile):
+  """Clock switches of the frequency plan (NN_EPOCH_FREQ_PLAN), done before the start of the block."""
+  switches = [(key, p) for key, p in sorted(profile.items()) if 'switches' in p]
+  if not switches:
+    return
+  print("--------------------------------------------------------------------------------------------")
+  total_ns = 0
+  for (net, eb), p in switches:
+    n = int(p['switches'])
+    ns = int(p['switch_ns'])
+    total_ns += ns
+    print(f"{net:12s} eb{eb:<3d} npu /{int(p['npu_div']):<3d} rams /{int(p['rams_div']):<3d} :"
+          f" {n:5d} switches {ns / n / 1000 if n else 0:8.3f} us per switch")
+  print(f"clock switches : {total_ns / 1000:10.1f} us")
+
+def display_wfe(profile):
+  """CPU clock choices of the NPU waits (CPU_FRQ_SCALE_DOWN_ADAPTIVE) of each epoch block."""
+  waits = [(key, p) for key, p in sorted(profile.items()) if 'wfe_down' in p]
+  if not waits:
+    return
+  print("--------------------------------------------------------------------------------------------")
+  total_down = total_kept = total_ns = 0
+  for (net, eb), p in waits:
+    down = int(p['wfe_down'])
+    kept = int(p['wfe_kept'])
+    ns = int(p['wfe_switch_ns'])
+    total_down += down
+    total_kept += kept
+    total_ns += ns
+    print(f"{net:12s} eb{eb:<3d} expected {int(p['learned_cycles']) / 1000:10.1f} kcycles : {down:5d} down {kept:5d} kept"
+          f" {ns / down / 1000 if down else 0:8.3f} us per down clocking")
+  print(f"cpu clock during npu waits : {total_down} down, {total_kept} kept, {total_ns / 1000:10.1f} us")
+
+# clock dividers of memory bound blocks in a generated frequency plan: the NPU profile does not
+# tell external memories from NPU RAMs, so the NPU RAMs are kept at the inference clock
+PLAN_MEMORY_BOUND_DIV = (2, 1)
+
+def write_freq_plan(profile, filename):
+  """
+  Frequency plan (Inc/nn_freq_plan.h) lowering the NPU clock of the memory bound hardware
+  epoch blocks of a stalls profile (NPU_PROFILE_STALLS), and restoring it for compute bound ones.
+  """
+  if not any('cycles' in p for p in profile.values()):
+    sys.exit("The frequency plan needs a profile of the stream engines, build the firmware with NPU_PROFILE_STALLS")
+  entries = []
+  current = {}
+  for (net, eb), p in sorted(profile.items()):
+    if not int(p.get('engines', 0)) or not int(p.get('cycles', 0)):
+      continue
+    div = PLAN_MEMORY_BOUND_DIV if int(p['active_max']) / int(p['cycles']) >= STREAM_BOUND_RATIO else (1, 1)
+    if current.get(net, (1, 1)) != div:
+      entries.append(f'  {{ "{net}", {eb}, {div[0]}, {div[1]} }},')
+      current[net] = div
+
+  with open(filename, newline='') as f:
+    header = f.read()
+  eol = '\r\n' if '\r\n' in header else '\n'
+  macro = '#define NN_FREQ_PLAN' + ''.join(' \\' + eol + e for e in entries)
+  header, n = re.subn(r'#define NN_FREQ_PLAN\b(?:[^\r\n]*\\\r?\n)*[^\r\n]*', lambda m: macro, header)
+  if n != 1:
+    sys.exit(f"NN_FREQ_PLAN not found in {filename}")
+  with open(filename, 'w', newline='') as f:
+    f.write(header)
+  print(f"{len(entries)} frequency plan entries written to {filename}")
+
+def display_epochs(datas, profile):
+  blocks, overhead = get_epoch_energy(datas)
+  if not blocks:
+    if profile:
+      display_npu_profile(profile, blocks)
+      display_freq_plan(profile)
+      display_wfe(profile)
+    else:
+      print("No epoch block step found, build the firmware with NN_EPOCH_TRACE")
+    return
+
+  total = sum(b['energy'] for b in blocks.values()) + sum(o[0] for o in overhead.values())
+  print("--------------------------------------------------------------------------------------------")
+  print("network      block kind epochs     :          energy       time   share  runs")
+  for (net, eb), b in sorted(blocks.items()):
+    print(f"{net:12s} eb{eb:<3d} {b['kind']:4s} {b['epochs']:10s} : {b['energy'] * 1000000:12.2f} uJ"
+          f" {b['time'] * 1000:8.3f} ms {b['energy'] * 100 / total:6.1f} % {b['runs']:5d}")
+  for net, o in sorted(overhead.items()):
+    print(f"{net:12s} runtime between blocks : {o[0] * 1000000:12.2f} uJ"
+          f" {o[1] * 1000:8.3f} ms {o[0] * 100 / total:6.1f} %")
+  print("--------------------------------------------------------------------------------------------")
+  for kind in ('hw', 'sw', 'hyb'):
+    e = sum(b['energy'] for b in blocks.values() if b['kind'] == kind)
+    t = sum(b['time'] for b in blocks.values() if b['kind'] == kind)
+    if t:
+      print(f"{kind:4s} epoch blocks : {e * 1000000:12.2f} uJ in {t * 1000:8.3f} ms ({e * 100 / total:5.1f} %)")
+  if profile:
+    display_npu_profile(profile, blocks)
+    display_freq_plan(profile)
+    display_wfe(profile)
+
+DVFS_STEP = re.compile(r'^op(?P<op>\d+) (?P<voltage>NOM|OD) n(?P<npu>\d+) r(?P<rams>\d+) c(?P<cpu>\d+)$')
+
+def get_dvfs_points(datas):
+  """
+  Inferences of the calibration sweep (DVFS_CALIBRATION) are steps named after their
+  operating point, the "config npu clock scaling" step before the first one is the
+  cost of switching to the operating point. Energy and latency are averaged over the runs.
+  """
+  points = {}
+  prev = None
+  for data in datas:
+    m = DVFS_STEP.match(data['seq_name'])
+    if m:
+      p = points.setdefault(int(m.group('op')), {
+        'name': data['seq_name'], 'energy': 0, 'time': 0, 'runs': 0, 'switch': 0})
+      p['energy'] += get_total_energy(data['datas'])
+      p['time'] += data['datas'][0][3]
+      p['runs'] += 1
+      if prev is not None and prev['seq_name'] == 'config npu clock scaling':
+        p['switch'] = get_total_energy(prev['datas'])
+    prev = data
+
+  for p in points.values():
+    p['energy'] /= p['runs']
+    p['time'] /= p['runs']
+
+  return points
+
+def select_dvfs_point(points, budget_ms):
+  """Lowest energy per inference among the points meeting the latency budget."""
+  candidates = [op for op, p in points.items() if budget_ms is None or p['time'] * 1000 <= budget_ms]
+  if not candidates:
+    return None
+  return min(candidates, key=lambda op: points[op]['energy'])
+
+def apply_dvfs_point(config_filename, op):
+  """Persist the operating point as DVFS_OPERATING_POINT default value of app_config.h."""
+  with open(config_filename, newline='') as f:
+    config = f.read()
+  config, n = re.subn(r'(#define DVFS_OPERATING_POINT +)-?\d+', lambda m: f"{m.group(1)}{op:<2d}", config)
+  if n != 1:
+    sys.exit(f"DVFS_OPERATING_POINT not found in {config_filename}")
+  with open(config_filename, 'w', newline='') as f:
+    f.write(config)
+
+def display_dvfs(datas, budget_ms, config_filename):
+  points = get_dvfs_points(datas)
+  if not points:
+    print("No operating point step found, build the firmware with NPU_FRQ_SCALING and DVFS_CALIBRATION")
+    return
+
+  selected = select_dvfs_point(points, budget_ms)
+  print("--------------------------------------------------------------------------------------------")
+  print("operating point          :  energy/inference    latency      switch  runs")
+  for op, p in sorted(points.items(), key=lambda item: item[1]['energy']):
+    within = budget_ms is None or p['time'] * 1000 <= budget_ms
+    print(f"{p['name']:24s} : {p['energy'] * 1000000:12.2f} uJ {p['time'] * 1000:8.3f} ms"
+          f" {p['switch'] * 1000000:8.2f} uJ {p['runs']:5d}"
+          f"{'' if within else '  over budget'}{'  <- selected' if op == selected else ''}")
+  print("--------------------------------------------------------------------------------------------")
+  if selected is None:
+    print(f"No operating point meets the {budget_ms} ms latency budget")
+    return
+  print(f"#define DVFS_OPERATING_POINT {selected}")
+  if config_filename:
+    apply_dvfs_point(config_filename, selected)
+    print(f"written to {config_filename}")
+
 def main(args):
   with open(args.csv_filename, newline='') as f:
     reader = csv.DictReader(f)
@@ -296,10 +629,22 @@ def main(args):
     rows = filter_sequence_samples(rows)
     full_sequence_time = get_time_list(rows)[-1] - get_time_list(rows)[0]
     res = get_power_per_state(rows)
+    records = read_npu_records(args.csv_filename)
     if args.raw:
       display_raw(res, args.verbose)
+    elif args.epochs:
+      profile = read_npu_profile(records)
+      display_epochs(res, profile)
+      if args.plan:
+        write_freq_plan(profile, args.plan)
+    elif args.dvfs:
+      display_dvfs(res, args.budget, args.apply)
     else:
       display_cooked(res, args.verbose, args.clocked_ip)
+    if not args.raw and not args.epochs:
+      display_clock_switches(read_clock_switches(records))
+      display_plls(read_plls(records), full_sequence_time)
+      display_smps(read_smps(records), res)
 
 def parse_args():
     parser = argparse.ArgumentParser()
@@ -308,6 +653,11 @@ def parse_args():
     parser.add_argument('-r', '--raw', action='store_true')
     parser.add_argument('-v', '--verbose', action='store_true', help='Increase output verbosity')
     parser.add_argument('-c', '--clocked_ip', action='store_true', help='display clock IPs tree')
+    parser.add_argument('-e', '--epochs', action='store_true', help='energy per NPU epoch block (NN_EPOCH_TRACE) and NPU profile (NPU_PROFILE)')
+    parser.add_argument('--plan', metavar='NN_FREQ_PLAN_H', help='write the frequency plan of the epoch blocks (NN_EPOCH_FREQ_PLAN), used with --epochs')
+    parser.add_argument('-d', '--dvfs', action='store_true', help='energy per operating point (DVFS_CALIBRATION) and lowest energy one')
+    parser.add_argument('-b', '--budget', type=float, help='latency budget of an inference in ms, used with --dvfs')
+    parser.add_argument('--apply', metavar='APP_CONFIG_H', help='write the selected operating point in app_config.h, used with --dvfs')
 
     args = parser.parse_args()
     return args
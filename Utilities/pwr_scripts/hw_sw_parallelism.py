@@ -0,0 +1,89 @@
+# /*---------------------------------------------------------------------------------------------
+#  * Copyright (c) 2024 STMicroelectronics.
+#  * All rights reserved.
+#  *
+#  * This software is licensed under terms that can be found in the LICENSE file in
+#  * the root directory of this software component.
+#  * If no LICENSE file comes with this software, it is provided AS-IS.
+#  *--------------------------------------------------------------------------------------------*/
+
+
+import argparse
+import csv
+
+from full_sequence_power import filter_sequence_samples, get_power_per_state, get_total_energy, read_npu_profile, read_npu_records
+
+# measured inference step, cold, dry run and cache check inferences are not compared
+INFERENCE_STEP = "nn inference"
+
+def read_cache_checks(records):
+  """Cache maintenance checks (NN_CACHE_CHECK)."""
+  checks = {}
+  for r in records['cache_check']:
+    c = checks.setdefault(r['cache_check'], {'checks': 0, 'mismatches': 0})
+    for k in ('checks', 'mismatches'):
+      c[k] += int(r[k])
+    for k in ('hw_blocks', 'sw_blocks', 'hyb_blocks'):
+      c[k] = int(r[k])
+  return checks
+
+def get_schedule(csv_filename):
+  with open(csv_filename, newline='') as f:
+    reader = csv.DictReader(f)
+    rows = filter_sequence_samples(list(reader))
+    res = get_power_per_state(rows)
+
+  inferences = [data for data in res if data['seq_name'] == INFERENCE_STEP]
+  if not inferences:
+    return None
+  energy = sum(get_total_energy(data['datas']) for data in inferences) / len(inferences)
+  duration = sum(data['datas'][0][3] for data in inferences) / len(inferences)
+
+  # epoch block time per kind (NPU_PROFILE), the software blocks are on the critical path
+  records = read_npu_records(csv_filename)
+  kinds = {}
+  for p in read_npu_profile(records).values():
+    if 'ns' in p:
+      kinds[p['kind']] = kinds.get(p['kind'], 0) + int(p['ns']) / 1e9
+
+  return {'inferences': len(inferences), 'energy': energy, 'duration': duration, 'kinds': kinds,
+          'checks': read_cache_checks(records)}
+
+def display_schedule(name, seq):
+  print(f"{name:8s}: {seq['energy'] * 1000000:10.1f} uJ in {seq['duration'] * 1000:8.3f} ms per inference"
+        f" ({seq['inferences']} inferences)")
+  if seq['kinds']:
+    print("          epoch blocks: " + ", ".join(f"{k} {t * 1000:.3f} ms" for k, t in sorted(seq['kinds'].items())))
+  for net, c in seq['checks'].items():
+    status = "ok" if c['mismatches'] == 0 else f"{c['mismatches']} MISMATCHES"
+    print(f"          cache check {net}: {c['hw_blocks']} hw, {c['sw_blocks']} sw, {c['hyb_blocks']} hyb blocks,"
+          f" {c['checks']} checks, {status}")
+
+def main(args):
+  serial = get_schedule(args.serial_csv)
+  parallel = get_schedule(args.parallel_csv)
+  if serial is None or parallel is None:
+    print(f"no \"{INFERENCE_STEP}\" step found")
+    return
+
+  print("--------------------------------------------------------------------------------------------")
+  display_schedule("serial", serial)
+  display_schedule("parallel", parallel)
+  print("--------------------------------------------------------------------------------------------")
+  dt = serial['duration'] - parallel['duration']
+  de = serial['energy'] - parallel['energy']
+  print(f"parallel schedule saves {dt * 1000:.3f} ms ({dt * 100 / serial['duration']:.1f} %) and"
+        f" {de * 1000000:.1f} uJ ({de * 100 / serial['energy']:.1f} %) per inference")
+  if any(c['mismatches'] for seq in (serial, parallel) for c in seq['checks'].values()):
+    print("WARNING: cache maintenance check failed, outputs differ from the reference run")
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+
+    parser.add_argument('serial_csv', help='capture with the network generated with the default profile (--no-hw-sw-parallelism)')
+    parser.add_argument('parallel_csv', help='capture with the network generated with the hw-sw-parallel profile')
+
+    args = parser.parse_args()
+    return args
+if __name__ == '__main__':
+  main(parse_args())
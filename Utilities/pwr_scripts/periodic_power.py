@@ -0,0 +1,75 @@
+# /*---------------------------------------------------------------------------------------------
+#  * Copyright (c) 2024 STMicroelectronics.
+#  * All rights reserved.
+#  *
+#  * This software is licensed under terms that can be found in the LICENSE file in
+#  * the root directory of this software component.
+#  * If no LICENSE file comes with this software, it is provided AS-IS.
+#  *--------------------------------------------------------------------------------------------*/
+
+
+import argparse
+import csv
+from statistics import mean
+
+from full_sequence_power import get_available_power_name
+
+def get_frames(rows):
+  # frames start on PA3 (STLINKPWR TGI) rising edge, active part ends on falling edge
+  starts = []
+  actives = []
+  prev = 0
+  for r in rows:
+    value = float(r['PA3'])
+    t = float(r['time'])
+    if value == 1 and prev == 0:
+      starts.append(t)
+    if value == 0 and prev == 1 and starts:
+      actives.append(t - starts[-1])
+    prev = value
+
+  return starts, actives
+
+def get_periodic(csv_filename):
+  with open(csv_filename, newline='') as f:
+    reader = csv.DictReader(f)
+    rows = list(reader)
+
+  assert 'PA3' in rows[0], "PA3 (STLINKPWR TGI) capture is required"
+  starts, actives = get_frames(rows)
+  if len(starts) < 2:
+    return None
+
+  # average power over complete periods only
+  power_name = get_available_power_name(rows)
+  window = [r for r in rows if starts[0] <= float(r['time']) < starts[-1]]
+  power = sum([mean([float(r[name]) for r in window]) for name in power_name])
+
+  periods = [b - a for a, b in zip(starts, starts[1:])]
+  period = mean(periods)
+
+  return {'frames': len(periods), 'period': period, 'period_jitter': max(periods) - min(periods),
+          'active': mean(actives[:len(periods)]), 'active_jitter': max(actives) - min(actives),
+          'power': power, 'energy': power * period}
+
+def main(args):
+  print("-------------------------------------------------------------------------------------------------------")
+  print(" file                           | frames | period ms | jitter ms |  fps  | active ms | jitter ms |  avg mW |  uJ/frame")
+  for csv_filename in args.csv:
+    res = get_periodic(csv_filename)
+    if res is None:
+      print(f" {csv_filename:30s} | less than two frames captured")
+      continue
+    print(f" {csv_filename:30s} | {res['frames']:6d} | {res['period'] * 1000:9.2f} | {res['period_jitter'] * 1000:9.3f} |"
+          f" {1 / res['period']:5.2f} | {res['active'] * 1000:9.2f} | {res['active_jitter'] * 1000:9.3f} |"
+          f" {res['power'] * 1000:7.2f} | {res['energy'] * 1000000:9.1f}")
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+
+    parser.add_argument('csv', nargs='+', help='captures of PERIODIC_CAPTURE runs, one per period')
+
+    args = parser.parse_args()
+    return args
+if __name__ == '__main__':
+  main(parse_args())
@@ -8,6 +8,7 @@
 #  *--------------------------------------------------------------------------------------------*/
 
 
+import os
 import threading
 import time
 
@@ -15,6 +16,11 @@ import serial
 
 import wrapper
 import numpy as np  
+
+def npu_profile_filename(csv_filename):
+    """NPU profile records are written next to the capture csv file."""
+    return os.path.splitext(csv_filename)[0] + '_npu.csv'
+
 # -----------------------------------------------------------------------------
 # STLINK PWR Section
 # -----------------------------------------------------------------------------
@@ -90,17 +96,29 @@ class StlinkComPort(threading.Thread):
     start_marker = '[SLP_SOL]'
     end_marker = '[SLP_EOL]'
     end_of_transmit = "END_OF_LOG"
+    # NPU profile records (NPU_PROFILE firmware option)
+    npu_start_marker = '[NPU_SOL]'
+    npu_end_marker = '[NPU_EOL]'
+    # Binary frame (PWR_TIMESTAMP_BINARY firmware option)
+    bin_sync = b'\xa5\x5a'
+    bin_version = 2
+    bin_header_size = 5
+    reg_names = ['DIVENR', 'MISCENR', 'MEMENR', 'AHB1ENR', 'AHB2ENR', 'AHB3ENR',
+                 'AHB4ENR', 'AHB5ENR', 'APB1LENR', 'APB1HENR', 'APB2ENR', 'APB3ENR',
+                 'APB4LENR', 'APB4HENR', 'APB5ENR']
 
     """Class for handling virtual COM port communication."""
-    def __init__(self, config, fields_name, port, baud_rate=115200, timeout=1):
+    def __init__(self, config, fields_name, port, baud_rate=115200, timeout=1, binary=False):
         super(StlinkComPort, self).__init__()
         self.port = port
         self.baud_rate = baud_rate
         self.timeout = timeout
+        self.binary = binary
         self.serial_connection = None
         self.running = False
         self.data = []
         self.rawdata = []
+        self.npu_profile = []
         self.fields_name = fields_name
         self.config = config
 
@@ -182,6 +200,109 @@ class StlinkComPort(threading.Thread):
         del split_data[2] #remove timestamp unit from list
         return split_data
 
+    @staticmethod
+    def crc16(data):
+        """CRC16-CCITT (poly 0x1021, init 0xFFFF), as computed by the firmware."""
+        crc = 0xFFFF
+        for byte in data:
+            crc ^= byte << 8
+            for _ in range(8):
+                crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+                crc &= 0xFFFF
+        return crc
+
+    @staticmethod
+    def decode_binary_frame(payload):
+        """Decode a binary frame payload into the records of the ASCII log format."""
+        records = []
+        names = []
+        regs = [0] * len(StlinkComPort.reg_names)
+        timestamp = 0
+        unit = 'ns' if payload[1] == 1 else 'us'
+        pos = 2
+        for _ in range(payload[0]):
+            idx = payload[pos]
+            pos += 1
+            if idx == len(names):
+                length = payload[pos]
+                names.append(payload[pos + 1:pos + 1 + length].decode('utf-8', errors='replace'))
+                pos += 1 + length
+            name = names[idx]
+
+            delta = 0
+            shift = 0
+            while True:
+                byte = payload[pos]
+                pos += 1
+                delta |= (byte & 0x7F) << shift
+                shift += 7
+                if not byte & 0x80:
+                    break
+            timestamp += delta
+            if unit == 'us':
+                # TIM2 counter, high resolution timestamps are 64 bits
+                timestamp &= 0xFFFFFFFF
+
+            mask = int.from_bytes(payload[pos:pos + 2], 'little')
+            pos += 2
+            for r in range(len(regs)):
+                if mask & (1 << r):
+                    regs[r] = int.from_bytes(payload[pos:pos + 4], 'little')
+                    pos += 4
+
+            fields = [name, str(timestamp), unit]
+            fields += [f"{n}={v}" for n, v in zip(StlinkComPort.reg_names, regs)]
+            records.append(':'.join(fields))
+        return records
+
+    @staticmethod
+    def extract_npu_profile(buffer):
+        """
+        Remove the NPU profile records from buffer (text or bytes).
+        Returns (records, remaining buffer), a record is a dict of its key=value fields.
+        """
+        binary = isinstance(buffer, bytes)
+        sol = StlinkComPort.npu_start_marker.encode() if binary else StlinkComPort.npu_start_marker
+        eol = StlinkComPort.npu_end_marker.encode() if binary else StlinkComPort.npu_end_marker
+        records = []
+        while True:
+            start = buffer.find(sol)
+            end = buffer.find(eol, start)
+            if start == -1 or end == -1:
+                return records, buffer
+            record = buffer[start + len(sol):end]
+            if binary:
+                record = record.decode('utf-8', errors='replace')
+            records.append(dict(f.split('=', 1) for f in record.split(':') if '=' in f))
+            buffer = buffer[:start] + buffer[end + len(eol):]
+
+    @staticmethod
+    def find_binary_frame(buffer):
+        """
+        Look for a valid binary frame in buffer, ASCII lines sent around the frame are skipped.
+        Returns (records, remaining buffer), records is None if no complete frame was found.
+        """
+        while True:
+            start = buffer.find(StlinkComPort.bin_sync)
+            if start == -1:
+                return None, buffer[-1:]
+            buffer = buffer[start:]
+            if len(buffer) < StlinkComPort.bin_header_size:
+                return None, buffer
+            length = int.from_bytes(buffer[3:5], 'little')
+            end = StlinkComPort.bin_header_size + length + 2
+            if buffer[2] != StlinkComPort.bin_version:
+                buffer = buffer[2:]
+                continue
+            if len(buffer) < end:
+                return None, buffer
+            crc = int.from_bytes(buffer[end - 2:end], 'little')
+            if crc != StlinkComPort.crc16(buffer[2:end - 2]):
+                print("   | info > Binary log frame with wrong CRC dropped")
+                buffer = buffer[2:]
+                continue
+            return StlinkComPort.decode_binary_frame(buffer[StlinkComPort.bin_header_size:end - 2]), buffer[end:]
+
     # Function to process incoming data
     @staticmethod
     def process_data(data):
@@ -202,9 +323,33 @@ class StlinkComPort(threading.Thread):
         except serial.SerialException as e:
             print(f"Could not open serial port {self.port}: {e}")
     
+    def run_binary(self):
+        """Read binary log frames from the COM port, an empty frame ends the log."""
+        self.running = True
+        buffer = b''
+        all_data = []
+        while self.running:
+            try:
+                if self.serial_connection.in_waiting:
+                    buffer += self.serial_connection.read(self.serial_connection.in_waiting)
+                    profile, buffer = StlinkComPort.extract_npu_profile(buffer)
+                    self.npu_profile += profile
+                    records, buffer = StlinkComPort.find_binary_frame(buffer)
+                    while records:
+                        all_data += records
+                        records, buffer = StlinkComPort.find_binary_frame(buffer)
+                    if records == []:
+                        self.rawdata = all_data
+                        self.running = False
+            except serial.SerialException as e:
+                print(f"Serial exception: {e}")
+                self.running = False
+
     def run(self):
         """Read data from the COM port and process it before appending."""
-        if self.serial_connection and self.serial_connection.is_open:
+        if self.serial_connection and self.serial_connection.is_open and self.binary:
+            self.run_binary()
+        elif self.serial_connection and self.serial_connection.is_open:
             self.running = True
             buffer = ''  # Initialize a buffer to hold incoming data
             all_data = []
@@ -214,6 +359,8 @@ class StlinkComPort(threading.Thread):
                         incoming_data = self.serial_connection.read(self.serial_connection.in_waiting).decode('utf-8')
                         if incoming_data:
                             buffer += incoming_data
+                            profile, buffer = StlinkComPort.extract_npu_profile(buffer)
+                            self.npu_profile += profile
 
                             if StlinkComPort.end_of_transmit in buffer:
                                 self.running = False
@@ -251,6 +398,10 @@ class StlinkComPort(threading.Thread):
             self.config.samples_nb)
         return self.data
     
+    def get_npu_profile(self):
+        """NPU profile records received with the log."""
+        return self.npu_profile
+
     def get_name(self):
         return self.fields_name
     